@@ -0,0 +1,37 @@
+#include "allocation.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::uint64_t> allocation_count = 0;
+
+void* Allocate(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) { size = 1; }
+    return std::malloc(size);
+}
+}  // namespace
+
+namespace qrot::bench {
+std::uint64_t AllocationCount() { return allocation_count.load(std::memory_order_relaxed); }
+}  // namespace qrot::bench
+
+// Replacement of global allocation functions
+void* operator new(std::size_t size) {
+    if (auto* ptr = Allocate(size)) { return ptr; }
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (auto* ptr = Allocate(size)) { return ptr; }
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
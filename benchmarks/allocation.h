@@ -0,0 +1,36 @@
+#ifndef QROT_BENCHMARKS_ALLOCATION_H
+#define QROT_BENCHMARKS_ALLOCATION_H
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace qrot::bench {
+/**
+ * @brief Number of calls of the global operator new (including operator new[]).
+ * @details Counting is available only in benchmarks linked with allocation.cpp, which replaces
+ * the global allocation functions.
+ */
+std::uint64_t AllocationCount();
+
+/**
+ * @brief Measure heap allocations between construction and Report().
+ */
+class AllocationCounter {
+public:
+    AllocationCounter() : start_{AllocationCount()} {}
+
+    /**
+     * @brief Report allocations per iteration as the counter "allocs/op".
+     */
+    void Report(benchmark::State& state) const {
+        const auto count = static_cast<double>(AllocationCount() - start_);
+        state.counters["allocs/op"] = benchmark::Counter(count, benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    std::uint64_t start_;
+};
+}  // namespace qrot::bench
+
+#endif  // QROT_BENCHMARKS_ALLOCATION_H
@@ -0,0 +1,102 @@
+#ifndef QROT_BENCHMARKS_COMMON_H
+#define QROT_BENCHMARKS_COMMON_H
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "qrot/diophantine.h"
+#include "qrot/gate.h"
+#include "qrot/grid_solver.h"
+#include "qrot/number.h"
+#include "qrot/parser.h"
+
+namespace qrot::bench {
+/// Fixed set of z-rotation angles (exact multiples of pi/4 are avoided)
+static inline constexpr auto Angles = std::array<std::string_view, 4>{"pi/128", "-pi/3", "0.1",
+                                                                       "2*pi/5"};
+/// Precision in decimal digits
+static inline constexpr auto Digits = std::array<std::int64_t, 5>{10, 20, 40, 70, 100};
+
+/**
+ * @brief Register all combinations of (angle index, digits).
+ */
+inline void AngleDigitsArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"angle", "digits"});
+    for (auto angle = std::size_t{0}; angle < Angles.size(); ++angle) {
+        for (const auto digits : Digits) { b->Args({static_cast<std::int64_t>(angle), digits}); }
+    }
+}
+inline void DigitsArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"digits"});
+    for (const auto digits : Digits) { b->Args({digits}); }
+}
+
+inline Float Theta(std::size_t angle) { return AST::Parse(std::string(Angles[angle])).Value(); }
+inline Float Epsilon(std::int64_t digits) { return Float("1e-" + std::to_string(digits)); }
+inline TwoDimGridSolver NewGridSolver(std::size_t angle, std::int64_t digits) {
+    return TwoDimGridSolver::New(-Theta(angle) / Float{2}, Epsilon(digits));
+}
+
+/**
+ * @brief Diophantine solver shared by all benchmarks (construction sieves 10^7 integers).
+ */
+inline const Diophantine& SharedDiophantine() {
+    static const auto diophantine = Diophantine();
+    return diophantine;
+}
+
+/**
+ * @brief Right-hand sides xi = 1 - |u|^2 for the first level of grid solutions.
+ */
+inline const std::vector<D2>& FirstLevelXis(std::size_t angle, std::int64_t digits) {
+    static auto cache = std::map<std::pair<std::size_t, std::int64_t>, std::vector<D2>>();
+    auto& xis = cache[{angle, digits}];
+    if (xis.empty()) {
+        auto grid_solver = NewGridSolver(angle, digits);
+        grid_solver.EnumerateAllSolutions();
+        for (const auto& u : grid_solver.GetSolutions()) {
+            xis.emplace_back(D2(1) - (u * u.Adj()).Real());
+        }
+    }
+    return xis;
+}
+
+/**
+ * @brief Integer norms factorized by Diophantine::Solve for the first level of grid solutions.
+ */
+inline std::vector<Integer> NormCorpus(std::size_t angle, std::int64_t digits) {
+    auto norms = std::vector<Integer>();
+    for (const auto& g : FirstLevelXis(angle, digits)) {
+        if (g < D2(0) || g.Adj2() < D2(0)) { continue; }
+        norms.emplace_back(Diophantine::Numerator(g).first.Norm());
+    }
+    return norms;
+}
+
+/**
+ * @brief Clifford+T gate in normal form with the T-count that gridsynth yields for `digits`.
+ * @details The T-count of gridsynth outputs is about 10 * digits (e.g. 104 for pi/128 with 10
+ * digits). Full synthesis with 100 digits takes minutes, so a deterministic random word with the
+ * same T-count is used for the stages after the Diophantine equation.
+ */
+inline Gate TypicalGate(std::int64_t digits) {
+    auto engine = std::mt19937(static_cast<std::uint32_t>(digits));
+    auto word = std::string("T");
+    for (auto i = std::int64_t{1}; i < 10 * digits; ++i) {
+        word += engine() % 2 == 0 ? "HT" : "SHT";
+    }
+    word += "HSX";
+    return Gate::FromString(word);
+}
+}  // namespace qrot::bench
+
+#endif  // QROT_BENCHMARKS_COMMON_H
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "boost/program_options.hpp"
+#include "boost/property_tree/json_parser.hpp"
+#include "boost/property_tree/ptree.hpp"
+#include "qrot/gridsynth.h"
+#include "qrot/parser.h"
+
+using namespace qrot;
+
+namespace {
+// clang-format off
+/// Fixed corpus of z-rotation angles
+static inline constexpr auto Angles = std::array<std::string_view, 12>{
+    // pi/2^k
+    "pi/8", "pi/16", "pi/64", "pi/128",
+    // Arbitrary reals
+    "0.123456", "-1.987654", "2.718281",
+    // Near-Clifford angles
+    "pi/4+0.001", "pi/2-0.00001", "pi-0.000001", "-pi/4-0.0001", "3*pi/2+0.0001",
+};
+// clang-format on
+static inline constexpr auto Digits = std::array<std::uint32_t, 3>{10, 20, 30};
+
+/**
+ * @brief Measurement of one (angle, digits) entry of the corpus.
+ */
+struct Entry {
+    std::string angle;
+    std::uint32_t digits = 0;
+    double time_ms = 0;   //!< End-to-end synthesis time (minimum over the repetitions)
+    double setup_ms = 0;  //!< Construction of the shared solvers, paid by the first synthesis only
+    std::size_t t_count = 0;
+    std::uint32_t level = 0;
+    std::size_t candidates_enumerated = 0;
+    std::size_t candidates_tried = 0;
+};
+using Key = std::pair<std::string, std::uint32_t>;
+
+Entry Run(std::string_view angle, std::uint32_t digits, std::uint32_t repetitions) {
+    const auto theta = AST::Parse(std::string(angle)).Value();
+    auto entry = Entry{std::string(angle), digits, std::numeric_limits<double>::max()};
+    for (auto i = std::uint32_t{0}; i < repetitions; ++i) {
+        const auto [gate, stats] = GridSynth(theta, digits);
+        // The next repetition factorizes its norms again, as a call with a new angle does
+        ClearGridSynthCache();
+        entry.time_ms = std::min(entry.time_ms, stats.total_ms);
+        entry.setup_ms = std::max(entry.setup_ms, stats.setup_ms);
+        entry.t_count = stats.t_count;
+        entry.level = stats.level;
+        entry.candidates_enumerated = stats.candidates_enumerated;
+        entry.candidates_tried = stats.candidates_tried;
+    }
+    return entry;
+}
+
+void WriteJson(std::ostream& out, const std::vector<Entry>& entries) {
+    out << "{\n  \"entries\": [";
+    for (auto i = std::size_t{0}; i < entries.size(); ++i) {
+        const auto& e = entries[i];
+        out << (i == 0 ? "" : ",") << "\n    {\"angle\": \"" << e.angle
+            << "\", \"digits\": " << e.digits << ", \"time_ms\": " << std::fixed
+            << std::setprecision(1) << e.time_ms << ", \"setup_ms\": " << e.setup_ms
+            << ", \"t_count\": " << e.t_count
+            << ", \"level\": " << e.level
+            << ", \"candidates_enumerated\": " << e.candidates_enumerated
+            << ", \"candidates_tried\": " << e.candidates_tried << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+std::map<Key, Entry> ReadJson(const std::string& path) {
+    namespace pt = boost::property_tree;
+    auto tree = pt::ptree();
+    pt::read_json(path, tree);
+    auto entries = std::map<Key, Entry>();
+    for (const auto& [_, node] : tree.get_child("entries")) {
+        auto e = Entry();
+        e.angle = node.get<std::string>("angle");
+        e.digits = node.get<std::uint32_t>("digits");
+        e.time_ms = node.get<double>("time_ms");
+        e.setup_ms = node.get<double>("setup_ms", 0);
+        e.t_count = node.get<std::size_t>("t_count");
+        e.level = node.get<std::uint32_t>("level");
+        e.candidates_enumerated = node.get<std::size_t>("candidates_enumerated");
+        e.candidates_tried = node.get<std::size_t>("candidates_tried");
+        entries.emplace(Key{e.angle, e.digits}, std::move(e));
+    }
+    return entries;
+}
+
+/**
+ * @brief Compare `entries` against `baseline` and print a report.
+ *
+ * @return number of regressions (slower beyond the tolerance, or a larger T-count)
+ */
+std::size_t Compare(const std::vector<Entry>& entries, const std::map<Key, Entry>& baseline,
+                    double tolerance, double slack_ms) {
+    auto regressions = std::size_t{0};
+    std::cout << std::left << std::setw(16) << "angle" << std::right << std::setw(8) << "digits"
+              << std::setw(14) << "baseline_ms" << std::setw(12) << "time_ms" << std::setw(10)
+              << "ratio" << std::setw(10) << "TCount" << "  status" << std::endl;
+    for (const auto& e : entries) {
+        const auto itr = baseline.find({e.angle, e.digits});
+        std::cout << std::left << std::setw(16) << e.angle << std::right << std::setw(8)
+                  << e.digits;
+        if (itr == baseline.end()) {
+            std::cout << std::setw(14) << "-" << std::setw(12) << e.time_ms << std::setw(10)
+                      << "-" << std::setw(10) << e.t_count << "  new" << std::endl;
+            continue;
+        }
+        const auto& b = itr->second;
+        const auto slower = e.time_ms > b.time_ms * (1 + tolerance) + slack_ms;
+        const auto worse = e.t_count > b.t_count;
+        auto status = std::string(slower || worse ? "REGRESSION" : "ok");
+        if (slower) { status += " (time)"; }
+        if (worse) { status += " (TCount " + std::to_string(b.t_count) + ")"; }
+        if (!worse && e.t_count < b.t_count) {
+            status += " (TCount improved from " + std::to_string(b.t_count) + ")";
+        }
+        if (e.candidates_tried != b.candidates_tried) {
+            status += " (candidates " + std::to_string(b.candidates_tried) + " -> " +
+                      std::to_string(e.candidates_tried) + ")";
+        }
+        std::cout << std::setw(14) << b.time_ms << std::setw(12) << e.time_ms << std::setw(10)
+                  << std::setprecision(2) << e.time_ms / std::max(b.time_ms, 1e-3)
+                  << std::setprecision(1) << std::setw(10) << e.t_count << "  " << status
+                  << std::endl;
+        if (slower || worse) { regressions++; }
+    }
+    return regressions;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+    namespace po = boost::program_options;
+
+    // Define description
+    // clang-format off
+    auto description = po::options_description("Synthesize a fixed corpus of angles and compare latency against a baseline");
+    description.add_options()
+        ("help,h", "Display available options")
+        ("output,o", po::value<std::string>(), "Write measurements to the JSON file")
+        ("baseline,b", po::value<std::string>(), "Compare measurements against the JSON file")
+        ("tolerance,t", po::value<double>()->default_value(0.5), "Allowed relative slowdown")
+        ("slack", po::value<double>()->default_value(100), "Allowed absolute slowdown in milliseconds")
+        ("repetitions,r", po::value<std::uint32_t>()->default_value(1), "Take the fastest of repeated runs")
+    ; // NOLINT
+    // clang-format on
+
+    auto vm = po::variables_map();
+    po::store(po::parse_command_line(argc, argv, description), vm);
+    po::notify(vm);
+
+    if (vm.count("help") > 0) {
+        std::cout << description << std::endl;
+        return 0;
+    }
+    const auto repetitions = std::max(vm["repetitions"].as<std::uint32_t>(), std::uint32_t{1});
+
+    auto entries = std::vector<Entry>();
+    for (const auto angle : Angles) {
+        for (const auto digits : Digits) {
+            entries.emplace_back(Run(angle, digits, repetitions));
+            std::cerr << "Synthesized " << angle << " with " << digits << " digits" << std::endl;
+        }
+    }
+
+    if (vm.count("output") > 0) {
+        const auto path = vm["output"].as<std::string>();
+        auto ofs = std::ofstream(path);
+        if (!ofs) {
+            std::cerr << "Failed to open " << path << std::endl;
+            return 1;
+        }
+        WriteJson(ofs, entries);
+    }
+    if (vm.count("baseline") == 0) {
+        WriteJson(std::cout, entries);
+        return 0;
+    }
+
+    auto baseline = std::map<Key, Entry>();
+    try {
+        baseline = ReadJson(vm["baseline"].as<std::string>());
+    } catch (std::exception& ex) {
+        std::cerr << "Failed to read baseline: " << ex.what() << std::endl;
+        return 1;
+    }
+    std::cout << std::fixed << std::setprecision(1);
+    const auto regressions = Compare(entries, baseline, vm["tolerance"].as<double>(),
+                                     vm["slack"].as<double>());
+    auto setup_ms = 0.0;
+    for (const auto& e : entries) { setup_ms += e.setup_ms; }
+    std::cout << "setup of the shared solvers: " << setup_ms
+              << " ms (paid by the first synthesis)" << std::endl;
+    std::cout << regressions << " regression(s) in " << entries.size() << " entries" << std::endl;
+    return regressions == 0 ? 0 : 1;
+}
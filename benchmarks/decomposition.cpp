@@ -0,0 +1,29 @@
+#include "qrot/decomposition.h"
+
+#include <benchmark/benchmark.h>
+
+#include "common.h"
+#include "perf_counters.h"
+
+using namespace qrot;
+using namespace qrot::bench;
+
+static void BM_UnitaryDecomposerConstruct(benchmark::State& state) {
+    for (auto _ : state) {
+        auto decomposer = UnitaryDecomposer();
+        benchmark::DoNotOptimize(&decomposer);
+    }
+}
+BENCHMARK(BM_UnitaryDecomposerConstruct)->Unit(benchmark::kMillisecond);
+
+static void BM_Decompose(benchmark::State& state) {
+    auto decomposer = UnitaryDecomposer();
+    const auto unitary = TypicalGate(state.range(0)).Mat();
+    auto perf = PerfCounters();
+    perf.Start();
+    for (auto _ : state) { benchmark::DoNotOptimize(decomposer.Decompose(unitary)); }
+    perf.Stop();
+    perf.Report(state);
+    state.counters["TCount"] = static_cast<double>(decomposer.Decompose(unitary).CountT());
+}
+BENCHMARK(BM_Decompose)->Apply(DigitsArgs)->Unit(benchmark::kMicrosecond);
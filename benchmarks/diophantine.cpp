@@ -0,0 +1,89 @@
+#include "qrot/diophantine.h"
+
+#include <benchmark/benchmark.h>
+
+#include "common.h"
+#include "perf_counters.h"
+
+using namespace qrot;
+using namespace qrot::bench;
+
+static void BM_DiophantineConstruct(benchmark::State& state) {
+    for (auto _ : state) {
+        auto diophantine = Diophantine();
+        benchmark::DoNotOptimize(&diophantine);
+    }
+}
+BENCHMARK(BM_DiophantineConstruct)->Unit(benchmark::kMillisecond);
+
+static void BM_FactorizeIntoPrime(benchmark::State& state) {
+    const auto& diophantine = SharedDiophantine();
+    const auto norms = NormCorpus(state.range(0), state.range(1));
+    auto perf = PerfCounters();
+    perf.Start();
+    for (auto _ : state) {
+        for (const auto& n : norms) {
+            auto fac = std::unordered_map<Integer, std::uint32_t>();
+            diophantine.FactorizeIntoPrime(n, fac);
+            benchmark::DoNotOptimize(fac);
+        }
+    }
+    perf.Stop();
+    perf.Report(state, static_cast<double>(norms.size()));
+    state.counters["norms"] = static_cast<double>(norms.size());
+}
+BENCHMARK(BM_FactorizeIntoPrime)->Apply(AngleDigitsArgs)->Unit(benchmark::kMillisecond);
+
+static void BM_FactorizeIntoPrimeBatch(benchmark::State& state) {
+    const auto& diophantine = SharedDiophantine();
+    const auto norms = NormCorpus(state.range(0), state.range(1));
+    auto perf = PerfCounters();
+    perf.Start();
+    for (auto _ : state) {
+        auto facs = std::vector<std::unordered_map<Integer, std::uint32_t>>();
+        diophantine.FactorizeIntoPrime(norms, facs);
+        benchmark::DoNotOptimize(facs);
+    }
+    perf.Stop();
+    perf.Report(state, static_cast<double>(norms.size()));
+    state.counters["norms"] = static_cast<double>(norms.size());
+}
+BENCHMARK(BM_FactorizeIntoPrimeBatch)->Apply(AngleDigitsArgs)->Unit(benchmark::kMillisecond);
+
+static void BM_DiophantineSolve(benchmark::State& state) {
+    auto diophantine = Diophantine();
+    const auto& xis = FirstLevelXis(state.range(0), state.range(1));
+    auto perf = PerfCounters();
+    for (auto _ : state) {
+        state.PauseTiming();
+        diophantine.ClearCache();
+        state.ResumeTiming();
+        perf.Start();
+        for (const auto& xi : xis) {
+            auto t = CD2();
+            benchmark::DoNotOptimize(diophantine.Solve(xi, t));
+        }
+        perf.Stop();
+    }
+    perf.Report(state, static_cast<double>(xis.size()));
+    state.counters["candidates"] = static_cast<double>(xis.size());
+}
+BENCHMARK(BM_DiophantineSolve)->Apply(AngleDigitsArgs)->Unit(benchmark::kMillisecond);
+
+static void BM_DiophantineSolveFirst(benchmark::State& state) {
+    auto diophantine = Diophantine();
+    const auto& xis = FirstLevelXis(state.range(0), state.range(1));
+    auto perf = PerfCounters();
+    for (auto _ : state) {
+        state.PauseTiming();
+        diophantine.ClearCache();
+        state.ResumeTiming();
+        perf.Start();
+        auto t = CD2();
+        benchmark::DoNotOptimize(diophantine.SolveFirst(xis, t));
+        perf.Stop();
+    }
+    perf.Report(state, static_cast<double>(xis.size()));
+    state.counters["candidates"] = static_cast<double>(xis.size());
+}
+BENCHMARK(BM_DiophantineSolveFirst)->Apply(AngleDigitsArgs)->Unit(benchmark::kMillisecond);
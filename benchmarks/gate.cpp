@@ -0,0 +1,51 @@
+#include "qrot/gate.h"
+
+#include <benchmark/benchmark.h>
+
+#include "common.h"
+#include "qrot/verification.h"
+
+using namespace qrot;
+using namespace qrot::bench;
+
+static void BM_Normalize(benchmark::State& state) {
+    const auto gate = TypicalGate(state.range(0));
+    // Concatenation of two normal forms is not normal in general
+    const auto input = gate * gate;
+    for (auto _ : state) {
+        auto tmp = input;
+        tmp.Normalize();
+        benchmark::DoNotOptimize(tmp);
+    }
+    state.counters["atoms"] = static_cast<double>(input.Size());
+}
+BENCHMARK(BM_Normalize)->Apply(DigitsArgs)->Unit(benchmark::kMicrosecond);
+
+static void BM_Mat(benchmark::State& state) {
+    const auto gate = TypicalGate(state.range(0));
+    for (auto _ : state) { benchmark::DoNotOptimize(gate.Mat()); }
+    state.counters["atoms"] = static_cast<double>(gate.Size());
+}
+BENCHMARK(BM_Mat)->Apply(DigitsArgs)->Unit(benchmark::kMicrosecond);
+
+static void BM_MatC(benchmark::State& state) {
+    const auto gate = TypicalGate(state.range(0));
+    for (auto _ : state) { benchmark::DoNotOptimize(ToMatC(gate.Mat())); }
+    state.counters["atoms"] = static_cast<double>(gate.Size());
+}
+BENCHMARK(BM_MatC)->Apply(DigitsArgs)->Unit(benchmark::kMicrosecond);
+
+static void BM_ExactUnitary(benchmark::State& state) {
+    const auto gate = TypicalGate(state.range(0));
+    for (auto _ : state) { benchmark::DoNotOptimize(ExactUnitary::FromGate(gate).ToMatC()); }
+    state.counters["atoms"] = static_cast<double>(gate.Size());
+}
+BENCHMARK(BM_ExactUnitary)->Apply(DigitsArgs)->Unit(benchmark::kMicrosecond);
+
+static void BM_RzDistance(benchmark::State& state) {
+    const auto gate = TypicalGate(state.range(0));
+    const auto theta = Theta(0);
+    for (auto _ : state) { benchmark::DoNotOptimize(RzDistance(gate, theta)); }
+    state.counters["atoms"] = static_cast<double>(gate.Size());
+}
+BENCHMARK(BM_RzDistance)->Apply(DigitsArgs)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,73 @@
+#include "qrot/grid_solver.h"
+
+#include <benchmark/benchmark.h>
+
+#include "common.h"
+#include "perf_counters.h"
+
+using namespace qrot;
+using namespace qrot::bench;
+
+static void BM_TwoDimGridSolverNew(benchmark::State& state, GridOperatorSearch search) {
+    const auto theta = -Theta(state.range(0)) / Float{2};
+    const auto epsilon = Epsilon(state.range(1));
+    auto perf = PerfCounters();
+    perf.Start();
+    for (auto _ : state) {
+        auto grid_solver = TwoDimGridSolver::New(theta, epsilon, search);
+        benchmark::DoNotOptimize(&grid_solver);
+    }
+    perf.Stop();
+    perf.Report(state);
+}
+BENCHMARK_CAPTURE(BM_TwoDimGridSolverNew, step, GridOperatorSearch::Step)
+    ->Apply(AngleDigitsArgs)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_TwoDimGridSolverNew, lattice, GridOperatorSearch::Lattice)
+    ->Apply(AngleDigitsArgs)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_EnumerateAllSolutions(benchmark::State& state) {
+    const auto theta = -Theta(state.range(0)) / Float{2};
+    const auto epsilon = Epsilon(state.range(1));
+    auto num_solutions = std::size_t{0};
+    auto perf = PerfCounters();
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto grid_solver = TwoDimGridSolver::New(theta, epsilon);
+        state.ResumeTiming();
+        perf.Start();
+        grid_solver.EnumerateAllSolutions();
+        perf.Stop();
+        num_solutions = grid_solver.GetSolutions().size();
+    }
+    perf.Report(state, static_cast<double>(num_solutions));
+    state.counters["solutions"] = static_cast<double>(num_solutions);
+}
+// Construction of the solver is not measured but dominates, so the iterations are fixed
+BENCHMARK(BM_EnumerateAllSolutions)
+    ->Apply(AngleDigitsArgs)
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_EnumerateNextLevel(benchmark::State& state) {
+    constexpr auto Levels = 4;
+    const auto theta = -Theta(state.range(0)) / Float{2};
+    const auto epsilon = Epsilon(state.range(1));
+    auto perf = PerfCounters();
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto grid_solver = TwoDimGridSolver::New(theta, epsilon);
+        grid_solver.EnumerateAllSolutions();
+        state.ResumeTiming();
+        perf.Start();
+        for (auto i = 0; i < Levels; ++i) { grid_solver.EnumerateNextLevelAllSolutions(); }
+        perf.Stop();
+    }
+    perf.Report(state, Levels);
+}
+// Escalation by four levels after the first level with solutions
+BENCHMARK(BM_EnumerateNextLevel)
+    ->Apply(AngleDigitsArgs)
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,30 @@
+#include "qrot/matrix.h"
+
+#include <benchmark/benchmark.h>
+
+#include "allocation.h"
+#include "ring.h"
+
+using namespace qrot;
+using namespace qrot::bench;
+
+template <typename T>
+static void BM_Det(benchmark::State& state) {
+    const auto pool = RandomPool<T>(state.range(0), 1);
+    auto i = std::size_t{0};
+    const auto counter = AllocationCounter();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pool[i].Det());
+        i = (i + 1) % PoolSize;
+    }
+    counter.Report(state);
+}
+
+BENCHMARK_TEMPLATE(BM_Add, MD2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Add, MCD2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Mul, MD2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Mul, MCD2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Equal, MD2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Equal, MCD2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Det, MD2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Det, MCD2)->Apply(BitsArgs);
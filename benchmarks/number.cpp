@@ -0,0 +1,67 @@
+#include "qrot/number.h"
+
+#include <benchmark/benchmark.h>
+
+#include "allocation.h"
+#include "ring.h"
+
+using namespace qrot;
+using namespace qrot::bench;
+
+template <typename T>
+static void BM_Less(benchmark::State& state) {
+    const auto lhs = RandomPool<T>(state.range(0), 1);
+    const auto rhs = RandomPool<T>(state.range(0), 2);
+    auto i = std::size_t{0};
+    const auto counter = AllocationCounter();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs[i] < rhs[i]);
+        i = (i + 1) % PoolSize;
+    }
+    counter.Report(state);
+}
+template <typename T>
+static void BM_Norm(benchmark::State& state) {
+    const auto pool = RandomPool<T>(state.range(0), 1);
+    auto i = std::size_t{0};
+    const auto counter = AllocationCounter();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pool[i].Norm());
+        i = (i + 1) % PoolSize;
+    }
+    counter.Report(state);
+}
+
+BENCHMARK_TEMPLATE(BM_Add, Integer)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Add, DyadicFraction)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Add, Z2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Add, D2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Add, CD2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Add, ZOmega)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Add, DOmega)->Apply(BitsArgs);
+
+BENCHMARK_TEMPLATE(BM_Mul, Integer)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Mul, DyadicFraction)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Mul, Z2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Mul, D2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Mul, CD2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Mul, ZOmega)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Mul, DOmega)->Apply(BitsArgs);
+
+BENCHMARK_TEMPLATE(BM_Equal, Integer)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Equal, DyadicFraction)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Equal, Z2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Equal, D2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Equal, CD2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Equal, ZOmega)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Equal, DOmega)->Apply(BitsArgs);
+
+BENCHMARK_TEMPLATE(BM_Less, Integer)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Less, DyadicFraction)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Less, D2)->Apply(BitsArgs);
+
+BENCHMARK_TEMPLATE(BM_Norm, Z2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Norm, D2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Norm, CD2)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Norm, ZOmega)->Apply(BitsArgs);
+BENCHMARK_TEMPLATE(BM_Norm, DOmega)->Apply(BitsArgs);
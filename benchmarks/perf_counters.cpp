@@ -0,0 +1,85 @@
+#include "perf_counters.h"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+namespace qrot::bench {
+namespace {
+constexpr auto Configs = std::array<std::uint64_t, PerfCounters::NumEvents>{
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES};
+
+bool Requested() {
+    const auto* env = std::getenv("QROT_PERF_COUNTERS");
+    return env != nullptr && std::string_view(env) != "" && std::string_view(env) != "0";
+}
+int Open(std::uint64_t config, int group_fd) {
+    auto attr = perf_event_attr();
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group_fd < 0 ? 1 : 0;  // Members follow the leader
+    attr.inherit = 1;                       // Count Pollard-Rho workers
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+std::uint64_t Read(int fd) {
+    auto value = std::uint64_t{0};
+    if (read(fd, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value))) { return 0; }
+    return value;
+}
+}  // namespace
+
+PerfCounters::PerfCounters() {
+    fds_.fill(-1);
+    if (!Requested()) { return; }
+    for (auto i = std::size_t{0}; i < NumEvents; ++i) {
+        fds_[i] = Open(Configs[i], i == 0 ? -1 : fds_[0]);
+        if (fds_[i] < 0) {
+            for (auto j = std::size_t{0}; j < i; ++j) { close(fds_[j]); }
+            fds_.fill(-1);
+            return;
+        }
+    }
+}
+PerfCounters::~PerfCounters() {
+    for (const auto fd : fds_) {
+        if (fd >= 0) { close(fd); }
+    }
+}
+void PerfCounters::Start() {
+    if (!Enabled()) { return; }
+    for (auto i = std::size_t{0}; i < NumEvents; ++i) { start_[i] = Read(fds_[i]); }
+    ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+void PerfCounters::Stop() {
+    if (!Enabled()) { return; }
+    ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    for (auto i = std::size_t{0}; i < NumEvents; ++i) { total_[i] += Read(fds_[i]) - start_[i]; }
+}
+void PerfCounters::Report(benchmark::State& state, double items_per_iteration) const {
+    if (!Enabled()) { return; }
+    using benchmark::Counter;
+
+    const auto count = [this](Event e) { return static_cast<double>(total_[e]); };
+    state.counters["cycles/op"] = Counter(count(Cycles), Counter::kAvgIterations);
+    state.counters["instructions/op"] = Counter(count(Instructions), Counter::kAvgIterations);
+    state.counters["IPC"] = count(Cycles) > 0 ? count(Instructions) / count(Cycles) : 0;
+    if (items_per_iteration > 0) {
+        const auto items = items_per_iteration * static_cast<double>(state.iterations());
+        state.counters["cache-misses/item"] = count(CacheMisses) / items;
+        state.counters["branch-misses/item"] = count(BranchMisses) / items;
+    } else {
+        state.counters["cache-misses/op"] = Counter(count(CacheMisses), Counter::kAvgIterations);
+        state.counters["branch-misses/op"] = Counter(count(BranchMisses), Counter::kAvgIterations);
+    }
+}
+}  // namespace qrot::bench
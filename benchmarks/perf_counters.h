@@ -0,0 +1,46 @@
+#ifndef QROT_BENCHMARKS_PERF_COUNTERS_H
+#define QROT_BENCHMARKS_PERF_COUNTERS_H
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+
+namespace qrot::bench {
+/**
+ * @brief Hardware performance counters read with Linux perf_event_open.
+ * @details Counters are opened only if the environment variable QROT_PERF_COUNTERS is set to a
+ * value other than "0". If they are not requested or the kernel refuses them (e.g.
+ * perf_event_paranoid or no PMU in a virtual machine), all methods are no-ops. Only user-space
+ * events of the calling thread and threads it spawns later are counted.
+ */
+class PerfCounters {
+public:
+    enum Event : std::size_t { Cycles, Instructions, CacheMisses, BranchMisses, NumEvents };
+
+    PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    ~PerfCounters();
+
+    bool Enabled() const { return fds_[0] >= 0; }
+    /**
+     * @brief Resume counting. Counts accumulate over pairs of Start() and Stop().
+     */
+    void Start();
+    void Stop();
+    /**
+     * @brief Report counts per iteration, IPC, and misses per item as benchmark counters.
+     *
+     * @param items_per_iteration e.g. candidates processed in each iteration (ignored if 0)
+     */
+    void Report(benchmark::State& state, double items_per_iteration = 0) const;
+
+private:
+    std::array<int, NumEvents> fds_;
+    std::array<std::uint64_t, NumEvents> start_ = {};
+    std::array<std::uint64_t, NumEvents> total_ = {};
+};
+}  // namespace qrot::bench
+
+#endif  // QROT_BENCHMARKS_PERF_COUNTERS_H
@@ -0,0 +1,129 @@
+#ifndef QROT_BENCHMARKS_RING_H
+#define QROT_BENCHMARKS_RING_H
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "allocation.h"
+#include "qrot/matrix.h"
+#include "qrot/number.h"
+
+namespace qrot::bench {
+/// Number of operands cycled through in each benchmark
+static inline constexpr auto PoolSize = std::size_t{64};
+
+/**
+ * @brief Register bit widths of the Integer coefficients.
+ */
+inline void BitsArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"bits"});
+    for (const auto bits : {64, 256, 1024}) { b->Args({bits}); }
+}
+
+using Engine = std::mt19937_64;
+
+#pragma region Random
+inline Integer Random(std::type_identity<Integer>, Engine& engine, std::int64_t bits) {
+    auto ret = Integer{0};
+    for (auto i = std::int64_t{0}; i < bits; i += 64) { ret = (ret << 64) | engine(); }
+    ret >>= (64 - bits % 64) % 64;
+    return engine() % 2 == 0 ? ret : Integer(-ret);
+}
+inline DyadicFraction Random(std::type_identity<DyadicFraction>, Engine& engine,
+                             std::int64_t bits) {
+    // Denominators of gridsynth are small compared with numerators
+    const auto den_exp = static_cast<std::int32_t>(engine() % 32);
+    return {Random(std::type_identity<Integer>(), engine, bits), den_exp};
+}
+template <typename Ring>
+SqrtRing<Ring> Random(std::type_identity<SqrtRing<Ring>>, Engine& engine, std::int64_t bits) {
+    const auto a = Random(std::type_identity<Ring>(), engine, bits);
+    const auto b = Random(std::type_identity<Ring>(), engine, bits);
+    return {a, b};
+}
+template <typename Ring>
+ComplexRing<Ring> Random(std::type_identity<ComplexRing<Ring>>, Engine& engine,
+                         std::int64_t bits) {
+    const auto r = Random(std::type_identity<Ring>(), engine, bits);
+    const auto i = Random(std::type_identity<Ring>(), engine, bits);
+    return {r, i};
+}
+template <typename Ring>
+OmegaRing<Ring> Random(std::type_identity<OmegaRing<Ring>>, Engine& engine, std::int64_t bits) {
+    const auto a = Random(std::type_identity<Ring>(), engine, bits);
+    const auto b = Random(std::type_identity<Ring>(), engine, bits);
+    const auto c = Random(std::type_identity<Ring>(), engine, bits);
+    const auto d = Random(std::type_identity<Ring>(), engine, bits);
+    return {a, b, c, d};
+}
+template <typename Ring>
+Matrix<Ring> Random(std::type_identity<Matrix<Ring>>, Engine& engine, std::int64_t bits) {
+    const auto a = Random(std::type_identity<Ring>(), engine, bits);
+    const auto b = Random(std::type_identity<Ring>(), engine, bits);
+    const auto c = Random(std::type_identity<Ring>(), engine, bits);
+    const auto d = Random(std::type_identity<Ring>(), engine, bits);
+    return {a, b, c, d};
+}
+/**
+ * @brief Deterministic operands whose Integer coefficients have `bits` bits.
+ */
+template <typename T>
+std::vector<T> RandomPool(std::int64_t bits, std::uint64_t seed = 0) {
+    auto engine = Engine(seed);
+    auto pool = std::vector<T>();
+    pool.reserve(PoolSize);
+    for (auto i = std::size_t{0}; i < PoolSize; ++i) {
+        pool.emplace_back(Random(std::type_identity<T>(), engine, bits));
+    }
+    return pool;
+}
+#pragma endregion Random
+
+#pragma region Benchmarks
+// Arithmetic benchmarks shared by all ring types. Each reports heap allocations per operation.
+// Results are converted to T so that expression templates of Integer are evaluated.
+template <typename T>
+void BM_Add(benchmark::State& state) {
+    const auto lhs = RandomPool<T>(state.range(0), 1);
+    const auto rhs = RandomPool<T>(state.range(0), 2);
+    auto i = std::size_t{0};
+    const auto counter = AllocationCounter();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(T(lhs[i] + rhs[i]));
+        i = (i + 1) % PoolSize;
+    }
+    counter.Report(state);
+}
+template <typename T>
+void BM_Mul(benchmark::State& state) {
+    const auto lhs = RandomPool<T>(state.range(0), 1);
+    const auto rhs = RandomPool<T>(state.range(0), 2);
+    auto i = std::size_t{0};
+    const auto counter = AllocationCounter();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(T(lhs[i] * rhs[i]));
+        i = (i + 1) % PoolSize;
+    }
+    counter.Report(state);
+}
+template <typename T>
+void BM_Equal(benchmark::State& state) {
+    const auto lhs = RandomPool<T>(state.range(0), 1);
+    // Equal operands compare all coefficients
+    const auto rhs = lhs;
+    auto i = std::size_t{0};
+    const auto counter = AllocationCounter();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs[i] == rhs[i]);
+        i = (i + 1) % PoolSize;
+    }
+    counter.Report(state);
+}
+#pragma endregion Benchmarks
+}  // namespace qrot::bench
+
+#endif  // QROT_BENCHMARKS_RING_H
@@ -1,4 +1,18 @@
 set(Boost_NO_WARN_NEW_VERSIONS 1)
 # find_package(OpenMP REQUIRED)
+find_package(Threads REQUIRED)
 find_package(Boost REQUIRED COMPONENTS program_options)
 find_package(GTest CONFIG REQUIRED)
+if(QROT_GMP)
+  find_path(GMP_INCLUDE_DIR gmp.h)
+  find_library(GMP_LIBRARY gmp)
+  if(NOT GMP_INCLUDE_DIR OR NOT GMP_LIBRARY)
+    message(FATAL_ERROR "QROT_GMP requires GMP")
+  endif()
+endif()
+if(QROT_BENCHMARK)
+  find_package(benchmark CONFIG)
+  if(NOT benchmark_FOUND)
+    message(STATUS "Google Benchmark not found, skipping the stage benchmarks")
+  endif()
+endif()
@@ -1,78 +1,13 @@
-#include <chrono>
 #include <iostream>
 #include <string>
 
 #include "boost/program_options.hpp"
-#include "qrot/decomposition.h"
-#include "qrot/diophantine.h"
-#include "qrot/gate.h"
-#include "qrot/grid_solver.h"
-#include "qrot/matrix.h"
-#include "qrot/number.h"
+#include "qrot/gridsynth.h"
 #include "qrot/parser.h"
+#include "qrot/trace.h"
 
 using namespace qrot;
 
-std::string GridSynth(const AST& ast, const std::uint32_t digits) {
-    namespace ch = std::chrono;
-    using Ms = ch::duration<double, std::milli>;
-
-    const auto t1 = ch::high_resolution_clock::now();
-    const auto theta = ast.Value();
-    auto grid_solver =
-        TwoDimGridSolver::New(-theta / Float{2}, Float("1e-" + std::to_string(digits)));
-    auto diophantine = Diophantine();
-    auto decomposer = UnitaryDecomposer();
-
-    const auto t2 = ch::high_resolution_clock::now();
-    grid_solver.EnumerateAllSolutions();
-
-    const auto t3 = ch::high_resolution_clock::now();
-    auto solutions = std::vector<std::pair<CD2, CD2>>();
-    while (solutions.empty()) {
-        const auto& grid_solutions = grid_solver.GetSolutions();
-        for (const auto& u : grid_solutions) {
-            auto t = CD2();
-            const auto xi = D2(1) - (u * u.Adj()).Real();
-            const auto solved = diophantine.Solve(xi, t);
-            if (solved) {
-                solutions.emplace_back(u, t);
-                break;
-            }
-        }
-        if (!solutions.empty()) {
-            break;
-        } else {
-            grid_solver.EnumerateNextLevelAllSolutions();
-        }
-    }
-
-    const auto t4 = ch::high_resolution_clock::now();
-    auto output = Gate();
-    auto t_count = std::numeric_limits<std::size_t>::max();
-    for (const auto& [u, t] : solutions) {
-        auto mat = MCD2(u, -t.Adj(), t, u.Adj());
-        const auto tmp = decomposer.Decompose(mat);
-        std::cout << "TCount = " << tmp.CountT() << std::endl;
-        if (tmp.CountT() < t_count) {
-            t_count = tmp.CountT();
-            output = tmp;
-        }
-    }
-
-    const auto t5 = ch::high_resolution_clock::now();
-#ifdef QROT_VERBOSE
-    std::cout << "----------------------------------" << std::endl;
-    std::cout << "Total Elapsed time = " << ch::duration_cast<Ms>(t5 - t1) << std::endl;
-    std::cout << "  Setup            = " << ch::duration_cast<Ms>(t2 - t1) << std::endl;
-    std::cout << "  GridProblem      = " << ch::duration_cast<Ms>(t3 - t2) << std::endl;
-    std::cout << "  Diophantine      = " << ch::duration_cast<Ms>(t4 - t3) << std::endl;
-    std::cout << "  Decompose        = " << ch::duration_cast<Ms>(t5 - t4) << std::endl;
-#endif
-
-    return output.ToString();
-}
-
 int main(int argc, char** argv) {
     namespace po = boost::program_options;
 
@@ -83,6 +18,8 @@ int main(int argc, char** argv) {
         ("help,h", "Display available options")
         ("theta", po::value<std::string>(), "z-rotation angle")
         ("digits,d", po::value<std::uint32_t>()->default_value(10), "Set precision in decimal digits")
+        ("stats", po::value<std::string>(), "Print statistics of each stage to stderr (format: json)")
+        ("trace", po::value<std::string>(), "Write trace events of each stage to the file (Chrome trace format)")
     ; // NOLINT
     // clang-format on
 
@@ -113,9 +50,24 @@ int main(int argc, char** argv) {
         return 1;
     }
     const auto digits = vm["digits"].as<std::uint32_t>();
+    if (vm.count("stats") > 0 && vm["stats"].as<std::string>() != "json") {
+        std::cerr << "Unknown stats format: " << vm["stats"].as<std::string>() << std::endl;
+        std::cerr << "Supported formats: json" << std::endl;
+        return 1;
+    }
 
-    const auto output = GridSynth(ast, digits);
-    std::cout << output << std::endl;
+    if (vm.count("trace") > 0) { Tracer::Global().Enable(); }
+    const auto [gate, stats] = GridSynth(ast, digits);
+    std::cout << "TCount = " << gate.CountT() << std::endl;
+    std::cout << gate.ToString() << std::endl;
+    if (vm.count("stats") > 0) { std::cerr << stats.ToJson() << std::endl; }
+    if (vm.count("trace") > 0) {
+        const auto path = vm["trace"].as<std::string>();
+        if (!Tracer::Global().Write(path)) {
+            std::cerr << "Failed to write trace: " << path << std::endl;
+            return 1;
+        }
+    }
 
     return 0;
 }
@@ -4,13 +4,36 @@
 #include "boost/multiprecision/cpp_complex.hpp"
 #include "boost/multiprecision/cpp_dec_float.hpp"
 #include "boost/multiprecision/cpp_int.hpp"
+#ifdef QROT_GMP
+#include "boost/multiprecision/gmp.hpp"
+#endif
+#ifdef QROT_OP_CENSUS
+#include "boost/multiprecision/logged_adaptor.hpp"
+#include "qrot/census.h"
+#endif
 
 namespace qrot {
 namespace mp = boost::multiprecision;
 static constexpr auto FloatPrecision = std::size_t{1728};
-using Integer = mp::cpp_int;
-using FloatBackend =
+// The code relies only on the generic interface of mp::number, so the backends are interchangeable.
+// -DQROT_GMP=ON selects the GMP backends, whose assembly kernels are faster for the
+// multi-hundred-bit integers handled in Diophantine
+#ifdef QROT_GMP
+using IntegerBackend = mp::gmp_int;
+using Rational = mp::mpq_rational;
+#else
+using IntegerBackend = mp::cpp_int_backend<>;
+using Rational = mp::cpp_rational;
+#endif
+using FloatBackendImpl =
     mp::cpp_bin_float<FloatPrecision, mp::backends::digit_base_2, void, std::int64_t>;
+#ifdef QROT_OP_CENSUS
+using Integer = mp::number<mp::logged_adaptor<IntegerBackend>>;
+using FloatBackend = mp::logged_adaptor<FloatBackendImpl>;
+#else
+using Integer = mp::number<IntegerBackend>;
+using FloatBackend = FloatBackendImpl;
+#endif
 using Float = mp::number<FloatBackend, mp::et_off>;
 using Complex = mp::number<mp::complex_adaptor<FloatBackend>, mp::et_off>;
 namespace constant::f {
@@ -26,4 +49,61 @@ static inline const Float InvLogLambda = 1 / mp::log(Lambda);
 }  // namespace constant::f
 }  // namespace qrot
 
+#ifdef QROT_OP_CENSUS
+// Hooks of logged_adaptor, which are more specialized than the default no-op hooks and found by
+// argument-dependent lookup
+namespace boost::multiprecision::backends {
+namespace census_detail {
+template <typename T>
+std::size_t Limbs(const T& x) {
+    if constexpr (std::is_same_v<T, qrot::IntegerBackend>) {
+#ifdef QROT_GMP
+        return mpz_size(x.data());
+#else
+        return static_cast<std::size_t>(x.size());
+#endif
+    } else {
+        return 1;
+    }
+}
+}  // namespace census_detail
+inline void log_prefix_event(const qrot::IntegerBackend& r, const char* op) {
+    qrot::census::Record(qrot::census::Kind::Integer, op, census_detail::Limbs(r));
+}
+template <typename T>
+void log_prefix_event(const qrot::IntegerBackend& r, const T& a, const char* op) {
+    qrot::census::Record(qrot::census::Kind::Integer, op,
+                         std::max(census_detail::Limbs(r), census_detail::Limbs(a)));
+}
+template <typename T, typename U>
+void log_prefix_event(const qrot::IntegerBackend&, const T& a, const U& b, const char* op) {
+    qrot::census::Record(qrot::census::Kind::Integer, op,
+                         std::max(census_detail::Limbs(a), census_detail::Limbs(b)));
+}
+template <typename T, typename U, typename V>
+void log_prefix_event(const qrot::IntegerBackend&, const T& a, const U& b, const V& c,
+                      const char* op) {
+    qrot::census::Record(qrot::census::Kind::Integer, op,
+                         std::max({census_detail::Limbs(a), census_detail::Limbs(b),
+                                   census_detail::Limbs(c)}));
+}
+inline void log_prefix_event(const qrot::FloatBackendImpl&, const char* op) {
+    qrot::census::Record(qrot::census::Kind::Float, op, 0);
+}
+template <typename T>
+void log_prefix_event(const qrot::FloatBackendImpl&, const T&, const char* op) {
+    qrot::census::Record(qrot::census::Kind::Float, op, 0);
+}
+template <typename T, typename U>
+void log_prefix_event(const qrot::FloatBackendImpl&, const T&, const U&, const char* op) {
+    qrot::census::Record(qrot::census::Kind::Float, op, 0);
+}
+template <typename T, typename U, typename V>
+void log_prefix_event(const qrot::FloatBackendImpl&, const T&, const U&, const V&,
+                      const char* op) {
+    qrot::census::Record(qrot::census::Kind::Float, op, 0);
+}
+}  // namespace boost::multiprecision::backends
+#endif
+
 #endif  // QROT_BOOST_H
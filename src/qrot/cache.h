@@ -0,0 +1,75 @@
+#ifndef QROT_CACHE_H
+#define QROT_CACHE_H
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace qrot {
+/**
+ * @brief Thread-safe key-value cache holding at most `capacity` entries.
+ * @details The least recently used entry is evicted when a new entry is inserted into a full
+ * cache.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class BoundedCache {
+public:
+    explicit BoundedCache(std::size_t capacity) : capacity_(capacity) {}
+
+    /**
+     * @brief Find the value of `key` and mark it as the most recently used.
+     *
+     * @return the cached value, or std::nullopt if `key` is not cached
+     */
+    std::optional<Value> Get(const Key& key) {
+        const auto lock = std::lock_guard(mtx_);
+        const auto itr = index_.find(key);
+        if (itr == index_.end()) { return std::nullopt; }
+        entries_.splice(entries_.begin(), entries_, itr->second);
+        return itr->second->second;
+    }
+    /**
+     * @brief Insert or overwrite the value of `key`.
+     */
+    void Put(const Key& key, Value value) {
+        if (capacity_ == 0) { return; }
+        const auto lock = std::lock_guard(mtx_);
+        const auto itr = index_.find(key);
+        if (itr != index_.end()) {
+            itr->second->second = std::move(value);
+            entries_.splice(entries_.begin(), entries_, itr->second);
+            return;
+        }
+        if (entries_.size() == capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+        entries_.emplace_front(key, std::move(value));
+        index_.emplace(key, entries_.begin());
+    }
+    void Clear() {
+        const auto lock = std::lock_guard(mtx_);
+        entries_.clear();
+        index_.clear();
+    }
+    std::size_t Size() const {
+        const auto lock = std::lock_guard(mtx_);
+        return entries_.size();
+    }
+    std::size_t Capacity() const { return capacity_; }
+
+private:
+    using Entry = std::pair<Key, Value>;
+
+    const std::size_t capacity_;
+    mutable std::mutex mtx_;
+    /// Entries ordered from the most recently used
+    std::list<Entry> entries_;
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index_;
+};
+}  // namespace qrot
+
+#endif  // QROT_CACHE_H
@@ -0,0 +1,122 @@
+#include "qrot/census.h"
+
+#include <bit>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+namespace qrot::census {
+namespace {
+constexpr auto NoStage = "(none)";
+
+/// (stage, kind, operation, log2 bucket of limbs)
+using Key = std::tuple<std::string, Kind, std::string, std::uint32_t>;
+
+std::uint32_t Bucket(std::size_t limbs) {
+    return limbs <= 1 ? 0 : static_cast<std::uint32_t>(std::bit_width(limbs - 1));
+}
+std::string BucketName(std::uint32_t bucket) {
+    if (bucket == 0) { return "1"; }
+    const auto hi = std::size_t{1} << bucket;
+    return bucket == 1 ? "2" : std::to_string(hi / 2 + 1) + "-" + std::to_string(hi);
+}
+
+/**
+ * @brief Counts of all threads, merged when each thread exits.
+ */
+class Global {
+public:
+    static Global& Get() {
+        static auto global = Global();
+        return global;
+    }
+    ~Global() {
+        // Threads including the main thread have merged their counts
+        if (!counts_.empty()) { Dump(std::cerr, {}); }
+    }
+    void Merge(const std::map<Key, std::uint64_t>& counts) {
+        const auto lock = std::lock_guard(mtx_);
+        for (const auto& [key, count] : counts) { counts_[key] += count; }
+    }
+    void Dump(std::ostream& out, const std::map<Key, std::uint64_t>& pending) const;
+
+private:
+    Global() = default;
+
+    mutable std::mutex mtx_;
+    std::map<Key, std::uint64_t> counts_;
+};
+
+/**
+ * @brief Counts of the calling thread keyed by addresses of static strings.
+ */
+class Local {
+public:
+    Local() { Global::Get(); }  // Make sure Global outlives Local of the main thread
+    ~Local() { Global::Get().Merge(Collect()); }
+
+    void Record(Kind kind, const char* op, std::size_t limbs) {
+        counts_[{stage, kind, op, Bucket(limbs)}]++;
+    }
+    std::map<Key, std::uint64_t> Collect() const {
+        auto counts = std::map<Key, std::uint64_t>();
+        for (const auto& [key, count] : counts_) {
+            counts[{key.stage, key.kind, key.op, key.bucket}] += count;
+        }
+        return counts;
+    }
+
+    const char* stage = NoStage;
+
+private:
+    struct RawKey {
+        const char* stage;
+        Kind kind;
+        const char* op;
+        std::uint32_t bucket;
+
+        bool operator==(const RawKey&) const = default;
+    };
+    struct RawKeyHash {
+        std::size_t operator()(const RawKey& key) const {
+            auto h = std::hash<const void*>()(key.stage);
+            h = h * 31 + std::hash<const void*>()(key.op);
+            return h * 31 + (static_cast<std::size_t>(key.kind) << 8 | key.bucket);
+        }
+    };
+
+    std::unordered_map<RawKey, std::uint64_t, RawKeyHash> counts_;
+};
+thread_local auto local = Local();
+
+void Global::Dump(std::ostream& out, const std::map<Key, std::uint64_t>& pending) const {
+    auto counts = [this] {
+        const auto lock = std::lock_guard(mtx_);
+        return counts_;
+    }();
+    for (const auto& [key, count] : pending) { counts[key] += count; }
+
+    out << "---------------- Multiprecision operation census ----------------\n";
+    out << std::left << std::setw(40) << "stage" << std::setw(8) << "kind" << std::setw(34)
+        << "operation" << std::setw(10) << "limbs" << std::right << std::setw(14) << "count"
+        << "\n";
+    for (const auto& [key, count] : counts) {
+        const auto& [stage, kind, op, bucket] = key;
+        out << std::left << std::setw(40) << stage << std::setw(8)
+            << (kind == Kind::Integer ? "Integer" : "Float") << std::setw(34) << op
+            << std::setw(10) << (kind == Kind::Integer ? BucketName(bucket) : "-") << std::right
+            << std::setw(14) << count << "\n";
+    }
+    out << std::flush;
+}
+}  // namespace
+
+void Record(Kind kind, const char* op, std::size_t limbs) { local.Record(kind, op, limbs); }
+void Dump(std::ostream& out) { Global::Get().Dump(out, local.Collect()); }
+
+Stage::Stage(const char* name) : prev_{local.stage} { local.stage = name; }
+Stage::~Stage() { local.stage = prev_; }
+}  // namespace qrot::census
@@ -0,0 +1,45 @@
+#ifndef QROT_CENSUS_H
+#define QROT_CENSUS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+/**
+ * @brief Census of multiprecision operations, enabled by the QROT_OP_CENSUS option.
+ * @details With QROT_OP_CENSUS, Integer and Float in boost.h are wrapped in
+ * boost::multiprecision::logged_adaptor, whose hooks call Record. Operations are counted per
+ * stage (the innermost QROT_TRACE_SCOPE of the calling thread), kind, operation and operand size,
+ * and the histogram is written to stderr at exit.
+ */
+namespace qrot::census {
+enum class Kind : std::uint8_t { Integer, Float };
+
+/**
+ * @brief Count an operation of the calling thread.
+ *
+ * @param op string with static storage duration
+ * @param limbs number of limbs of the largest operand (0 for Float)
+ */
+void Record(Kind kind, const char* op, std::size_t limbs);
+/**
+ * @brief Write the histogram of operations counted so far (including finished threads).
+ */
+void Dump(std::ostream& out);
+
+/**
+ * @brief Attribute operations of the calling thread to `name` during the lifetime of this object.
+ */
+class Stage {
+public:
+    explicit Stage(const char* name);
+    Stage(const Stage&) = delete;
+    Stage& operator=(const Stage&) = delete;
+    ~Stage();
+
+private:
+    const char* const prev_;
+};
+}  // namespace qrot::census
+
+#endif  // QROT_CENSUS_H
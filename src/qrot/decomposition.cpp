@@ -6,6 +6,8 @@
 #include <queue>
 #include <sstream>
 
+#include "qrot/trace.h"
+
 namespace qrot {
 namespace {
 static inline const auto StepGate = constant::mcd2::H * constant::mcd2::TDag * constant::mcd2::H;
@@ -20,6 +22,7 @@ std::int32_t SDE(const D2& x) {
 }
 }  // namespace
 UnitaryDecomposer::UnitaryDecomposer() {
+    QROT_TRACE_SCOPE("UnitaryDecomposer::UnitaryDecomposer");
     auto ss = std::stringstream(
 #include "qrot/s3.txt"
     );
@@ -153,7 +156,8 @@ Gate UnitaryDecomposer::LookUpS3(const MCD2& x) const {
     throw std::logic_error("Cannot find unitary for input matrix in s3 database");
     return Gate();
 }
-Gate UnitaryDecomposer::Decompose(const MCD2& input) {
+Gate UnitaryDecomposer::Decompose(const MCD2& input, bool normalize) const {
+    QROT_TRACE_SCOPE("UnitaryDecomposer::Decompose");
     using namespace constant;
     using constant::mcd2::H;
 
@@ -185,7 +189,7 @@ Gate UnitaryDecomposer::Decompose(const MCD2& input) {
     // Look up
     output *= LookUpS3(unitary);
 
-    output.Normalize();
+    if (normalize) { output.Normalize(); }
     return output;
 }
 }  // namespace qrot
@@ -18,7 +18,14 @@ class UnitaryDecomposer {
 public:
     UnitaryDecomposer();
 
-    Gate Decompose(const MCD2& input);
+    /**
+     * @brief Decompose `input` into Clifford+T gates.
+     *
+     * @param input unitary matrix
+     * @param normalize convert the output into the normal form (otherwise the output is the raw
+     * sequence of the SDE reduction)
+     */
+    Gate Decompose(const MCD2& input, bool normalize = true) const;
 
 private:
     void InitializeStorage();
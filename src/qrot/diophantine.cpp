@@ -1,11 +1,22 @@
 #include "qrot/diophantine.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <mutex>
 #include <queue>
+#include <stop_token>
+#include <thread>
 #include <unordered_map>
 
+#include "boost/multiprecision/miller_rabin.hpp"
+#include "qrot/isa.h"
+#include "qrot/trace.h"
+
 namespace qrot {
 namespace {
+constexpr auto MillerRabinTrials = 25;
 Z2 CalcUnit(const D2& x, const D2& y) {
     // Assert x = o * y (o is unit in Z2)
     // Calculate x / y
@@ -26,9 +37,6 @@ Z2 CalcUnit(const D2& x, const D2& y) {
     return num;
 }
 Z2 SqrtOfUnit(const Z2& x) {
-#ifdef QROT_VERBOSE
-    std::cout << "Calculate sqrt of " << x << ", norm = " << x.Norm() << std::endl;
-#endif
     const auto& a = x.Int();
     const auto i1 = static_cast<Integer>(mp::sqrt((a + 1) / 2));  // FIXME: use int sqrt
     const auto i2 = static_cast<Integer>(mp::sqrt((a - 1) / 2));  // FIXME: use int sqrt
@@ -50,48 +58,289 @@ Z2 SqrtOfUnit(const Z2& x) {
     assert(0 && "Unreachable if x is unit");
     return Z2(0, 0);
 }
+bool PassRoughCheck(const std::unordered_map<Integer, std::uint32_t>& fac) {
+    for (const auto& [p, n] : fac) {
+        if (p % 8 == 3 && n % 2 != 0) { return false; }
+        if (p % 8 == 5 && n % 2 != 0) { return false; }
+        if (p % 8 == 7 && n % 2 != 0) { return false; }
+    }
+    return true;
+}
+/**
+ * @brief Build a product tree whose first level is `leaves` and last level is the root.
+ * @details The tree is truncated at `height` levels.
+ */
+std::vector<std::vector<Integer>> ProductTree(
+    std::vector<Integer> leaves, std::size_t height = std::numeric_limits<std::size_t>::max()) {
+    auto tree = std::vector<std::vector<Integer>>();
+    tree.emplace_back(std::move(leaves));
+    while (tree.back().size() > 1 && tree.size() < height) {
+        const auto& prev = tree.back();
+        auto next = std::vector<Integer>();
+        next.reserve((prev.size() + 1) / 2);
+        for (auto i = std::size_t{0}; i + 1 < prev.size(); i += 2) {
+            next.emplace_back(prev[i] * prev[i + 1]);
+        }
+        if (prev.size() % 2 == 1) { next.emplace_back(prev.back()); }
+        tree.emplace_back(std::move(next));
+    }
+    return tree;
+}
+/**
+ * @brief Calculate x mod (each leaf of `tree`) by reducing x from the root to the leaves.
+ */
+void RemainderTree(const Integer& x, const std::vector<std::vector<Integer>>& tree,
+                   std::vector<Integer>& rems) {
+    rems.assign(1, x % tree.back().front());
+    auto next = std::vector<Integer>();
+    for (auto level = tree.size() - 1; level-- > 0;) {
+        const auto& nodes = tree[level];
+        next.resize(nodes.size());
+        for (auto i = std::size_t{0}; i < nodes.size(); ++i) { next[i] = rems[i / 2] % nodes[i]; }
+        std::swap(rems, next);
+    }
+}
+/**
+ * @brief Brent's variant of Pollard-Rho algorithm with f(x) = x^2 + offset.
+ * @details The gcd is calculated once per `BatchSize` steps on the product of |x - y|. The search
+ * gives up after `MaxLoops` evaluations of f, including the r steps by which y is advanced before
+ * each round. This is the same search as 10'000 batch steps without counting the advances.
+ *
+ * @return true if n % p == 0
+ * @return false if no divisor is found within the loop limit or the search is cancelled
+ */
+bool PollardBrent(const Integer& n, std::uint32_t offset, std::stop_token stop, Integer& p) {
+    QROT_TRACE_SCOPE("PollardBrent");
+    constexpr auto MaxLoops = std::uint32_t{1} << 15;
+    constexpr auto BatchSize = std::uint32_t{128};
+    const auto f = [&n, offset](const Integer& x) -> Integer { return (x * x + offset) % n; };
+
+    auto x = Integer{};
+    auto y = Integer{2};
+    auto ys = Integer{};
+    auto q = Integer{1};
+    auto g = Integer{1};
+    auto steps = std::uint32_t{0};
+    for (auto r = std::uint32_t{1}; g == 1 && steps < MaxLoops; r *= 2) {
+        x = y;
+        for (auto i = std::uint32_t{0}; i < r; ++i) { y = f(y); }
+        steps += r;
+        for (auto k = std::uint32_t{0}; k < r && g == 1 && steps < MaxLoops; k += BatchSize) {
+            if (stop.stop_requested()) { return false; }
+            ys = y;
+            const auto batch = std::min(BatchSize, r - k);
+            for (auto i = std::uint32_t{0}; i < batch; ++i) {
+                y = f(y);
+                q = (q * mp::abs(x - y)) % n;
+            }
+            g = mp::gcd(q, n);
+            steps += batch;
+        }
+    }
+    if (g == n) {
+        // The batch overshot: retry the last batch step by step
+        do {
+            ys = f(ys);
+            g = mp::gcd(mp::abs(x - ys), n);
+        } while (g == 1);
+    }
+    if (g == 1 || g == n) { return false; }
+    p = g;
+    return true;
+}
 bool Dividable(const Z2& x, const Z2& y) {
     // Is x / y is Z2 ?
     const auto norm = y.Norm();
     const auto num = x * y.Adj2();
     return num.Int() % norm == 0 && num.Sqrt() % norm == 0;
 }
+/**
+ * @brief Remainders of n modulo primes[0], ..., primes[size - 1] in (-p, p).
+ * @details n is streamed as 16-bit chunks from the most significant one. While |r| < p < 2^24,
+ * x = r * 2^16 + chunk is exact in double and q = round(x / p) is obtained from the reciprocal by
+ * adding and subtracting 1.5 * 2^52, so x - q p is exact and again smaller than p in magnitude.
+ * Hence p divides n iff the remainder is 0. The lanes have no branch, so the loop over primes is
+ * vectorized.
+ */
+QROT_ALWAYS_INLINE void SmallPrimeRemaindersBody(const std::vector<std::uint16_t>& chunks,
+                                                 const double* primes, const double* inv_primes,
+                                                 std::size_t size, double* rems) {
+    constexpr auto Round = 0x1.8p52;
+    std::fill(rems, rems + size, 0.0);
+    for (const auto chunk : chunks) {
+        const auto c = static_cast<double>(chunk);
+        for (auto i = std::size_t{0}; i < size; ++i) {
+            const auto x = rems[i] * 0x1p16 + c;
+            const auto q = (x * inv_primes[i] + Round) - Round;
+            rems[i] = x - q * primes[i];
+        }
+    }
+}
+using SmallPrimeRemaindersFn = void(const std::vector<std::uint16_t>&, const double*,
+                                    const double*, std::size_t, double*);
+void SmallPrimeRemaindersScalar(const std::vector<std::uint16_t>& chunks, const double* primes,
+                                const double* inv_primes, std::size_t size, double* rems) {
+    SmallPrimeRemaindersBody(chunks, primes, inv_primes, size, rems);
+}
+#ifdef QROT_ISA_DISPATCH
+QROT_TARGET_AVX2 void SmallPrimeRemaindersAVX2(const std::vector<std::uint16_t>& chunks,
+                                               const double* primes, const double* inv_primes,
+                                               std::size_t size, double* rems) {
+    SmallPrimeRemaindersBody(chunks, primes, inv_primes, size, rems);
+}
+QROT_TARGET_AVX512 void SmallPrimeRemaindersAVX512(const std::vector<std::uint16_t>& chunks,
+                                                   const double* primes, const double* inv_primes,
+                                                   std::size_t size, double* rems) {
+    SmallPrimeRemaindersBody(chunks, primes, inv_primes, size, rems);
+}
+#endif
+const auto SmallPrimeRemainders = IsaKernel<SmallPrimeRemaindersFn>{
+#ifdef QROT_ISA_DISPATCH
+    &SmallPrimeRemaindersScalar, &SmallPrimeRemaindersAVX2, &SmallPrimeRemaindersAVX512
+#else
+    &SmallPrimeRemaindersScalar
+#endif
+};
+/**
+ * @brief Divide n by p as many times as possible.
+ *
+ * @return exponent of p in n
+ */
+std::uint32_t DivideOut(Integer& n, const Integer& p) {
+    auto exponent = std::uint32_t{0};
+    auto q = Integer();
+    auto r = Integer();
+    mp::divide_qr(n, p, q, r);
+    while (r == 0) {
+        n = q;
+        exponent++;
+        mp::divide_qr(n, p, q, r);
+    }
+    return exponent;
+}
 }  // namespace
-Diophantine::Diophantine() {
+Diophantine::Diophantine()
+    : pollard_rho_pool_{
+          std::clamp(std::thread::hardware_concurrency(), std::uint32_t{1}, PollardRhoOffsets)} {
+    QROT_TRACE_SCOPE("Diophantine::Diophantine");
     constexpr auto SearchLimit = std::size_t{10'000'000};
+    static_assert(SearchLimit < (std::size_t{1} << 24), "SmallPrimeRemainders needs p < 2^24");
     auto is_prime = std::vector<bool>(SearchLimit, true);
     is_prime[0] = is_prime[1] = false;
     for (auto i = std::size_t{2}; i < SearchLimit; ++i) {
         if (is_prime[i]) {
             primes_.emplace_back(Integer(i));
+            prime_values_.emplace_back(static_cast<double>(i));
+            inv_primes_.emplace_back(1 / static_cast<double>(i));
             for (auto j = i * i; j < SearchLimit; j += i) { is_prime[j] = false; }
         }
     }
+    auto chunks = std::vector<Integer>();
+    for (auto begin = std::size_t{0}; begin < primes_.size(); begin += PrimesPerChunk) {
+        const auto end = std::min(begin + PrimesPerChunk, primes_.size());
+        const auto tree = ProductTree({primes_.begin() + begin, primes_.begin() + end});
+        chunks.emplace_back(tree.back().front());
+    }
+    prime_tree_ = ProductTree(std::move(chunks), PrimeTreeHeight);
 }
-bool Diophantine::Solve(const D2& g, CD2& t) const {
-    using constant::cd2::Delta;
-    if (g < D2(0)) { return false; }
-    if (g.Adj2() < D2(0)) { return false; }
-
+std::pair<Z2, std::int32_t> Diophantine::Numerator(const D2& g) {
     const auto tmp_den_exp = std::max(g.Int().DenExp(), g.Sqrt().DenExp());
     const auto den_exp = tmp_den_exp % 2 == 0 ? tmp_den_exp : tmp_den_exp + 1;
     assert(den_exp % 2 == 0);
-    const auto num = Z2(g.Int().Num() << (den_exp - g.Int().DenExp()),
-                        g.Sqrt().Num() << (den_exp - g.Sqrt().DenExp()));
-    const auto norm = num.Norm();
+    auto num = Z2(g.Int().Num() << (den_exp - g.Int().DenExp()),
+                  g.Sqrt().Num() << (den_exp - g.Sqrt().DenExp()));
+    return {std::move(num), den_exp};
+}
+bool Diophantine::Solve(const D2& g, CD2& t) const { return SolveFirst({g}, t) == 0; }
+std::size_t Diophantine::SolveFirst(const std::vector<D2>& gs, CD2& t) const {
+    auto stats = Stats();
+    return SolveFirst(gs, t, stats);
+}
+std::size_t Diophantine::SolveFirst(const std::vector<D2>& gs, CD2& t, Stats& stats) const {
+    QROT_TRACE_SCOPE("Diophantine::SolveFirst");
+    auto indices = std::vector<std::size_t>();
+    auto nums = std::vector<Z2>();
+    auto den_exps = std::vector<std::int32_t>();
+    auto norms = std::vector<Integer>();
+    // t = 0 solves g = 0, whose norm 0 cannot be factorized. Later candidates are irrelevant
+    auto zero_index = gs.size();
+    for (auto i = std::size_t{0}; i < gs.size(); ++i) {
+        const auto& g = gs[i];
+        if (g == D2(0)) {
+            zero_index = i;
+            break;
+        }
+        if (g < D2(0)) { continue; }
+        if (g.Adj2() < D2(0)) { continue; }
 
-#ifdef QROT_VERBOSE
-    std::cout << "Factorize " << num << " (norm = " << norm << ")" << std::endl;
-#endif
+        const auto [num, den_exp] = Numerator(g);
+        indices.emplace_back(i);
+        nums.emplace_back(num);
+        den_exps.emplace_back(den_exp);
+        norms.emplace_back(num.Norm());
+    }
 
-    auto fac = std::unordered_map<Integer, std::uint32_t>();
-    FactorizeIntoPrime(norm, fac);
+    // Candidates are factorized in chunks of doubling size, so that a level with many candidates,
+    // of which usually only the first few are tried, does not factorize all of them up front
+    for (auto begin = std::size_t{0}, size = FirstChunkSize; begin < norms.size();
+         begin += size, size *= 2) {
+        const auto end = std::min(begin + size, norms.size());
 
-#ifdef QROT_VERBOSE
-    std::cout << "Prime factorization = ";
-    for (const auto& [p, n] : fac) { std::cout << "{" << p << ", " << n << "}"; }
-    std::cout << std::endl;
-#endif
+        // Only norms missing in the cache are factorized
+        auto facs = std::vector<std::unordered_map<Integer, std::uint32_t>>(end - begin);
+        auto cofactors = std::vector<Integer>(end - begin, 1);
+        auto cached = std::vector<bool>(end - begin, false);
+        auto missing = std::vector<std::size_t>();
+        auto missing_norms = std::vector<Integer>();
+        for (auto k = std::size_t{0}; k < end - begin; ++k) {
+            if (auto fac = factorization_cache_.Get(norms[begin + k])) {
+                facs[k] = std::move(*fac);
+                cached[k] = true;
+                stats.cache_hits++;
+            } else {
+                missing.emplace_back(k);
+                missing_norms.emplace_back(norms[begin + k]);
+            }
+        }
+        auto missing_facs = std::vector<std::unordered_map<Integer, std::uint32_t>>();
+        FactorizeIntoSmallPrime(missing_norms, missing_facs);
+        for (auto k = std::size_t{0}; k < missing.size(); ++k) {
+            facs[missing[k]] = std::move(missing_facs[k]);
+            cofactors[missing[k]] = std::move(missing_norms[k]);
+        }
+
+        for (auto k = std::size_t{0}; k < end - begin; ++k) {
+            const auto j = begin + k;
+            stats.tried++;
+            if (norms[j] > 0) {
+                stats.max_norm_bits =
+                    std::max(stats.max_norm_bits, static_cast<std::size_t>(mp::msb(norms[j]) + 1));
+            }
+
+            // Exponents of small primes are exact, so the rough check can reject early
+            if (!PassRoughCheck(facs[k])) {
+                if (!cached[k]) { factorization_cache_.Put(norms[j], facs[k]); }
+                stats.rejected++;
+                continue;
+            }
+
+            if (!cached[k]) {
+                stats.factorization_failures += FactorizeIntoLargePrime(cofactors[k], facs[k]);
+                factorization_cache_.Put(norms[j], facs[k]);
+            }
+            if (SolveImpl(gs[indices[j]], nums[j], den_exps[j], facs[k], t)) { return indices[j]; }
+            stats.rejected++;
+        }
+    }
+    if (zero_index < gs.size()) {
+        stats.tried++;
+        t = CD2(0);
+    }
+    return zero_index;
+}
+bool Diophantine::SolveImpl(const D2& g, const Z2& num, std::int32_t den_exp,
+                            const std::unordered_map<Integer, std::uint32_t>& fac, CD2& t) const {
+    using constant::cd2::Delta;
 
     // NOTE: Prime factorization of large integers can fail.
     // If the prime factorization is successful, we can always find a solution for the case that
@@ -100,11 +349,7 @@ bool Diophantine::Solve(const D2& g, CD2& t) const {
     // We return `g == t.Norm()` so that the program works well even if prime factorization fails.
 
     // Rough check
-    for (const auto& [p, n] : fac) {
-        if (p % 8 == 3 && n % 2 != 0) { return false; }
-        if (p % 8 == 5 && n % 2 != 0) { return false; }
-        if (p % 8 == 7 && n % 2 != 0) { return false; }
-    }
+    if (!PassRoughCheck(fac)) { return false; }
 
     // If the rough check passes, a solution always exists (if prime factorization is successful)
     t = CD2(1, 0);
@@ -113,34 +358,14 @@ bool Diophantine::Solve(const D2& g, CD2& t) const {
             const auto r = p % 8;
 
             if (n % 2 == 0) {
-                if (r == 1) {
-                    // r^2 = 2 mod p
-                    // xi = gcd(p, r + \sqrt{2})
-                    const auto r = SqrtMod(2, p);
-                    auto xi = EuclidGCD(p, Z2(r, 1));  // xi or xi^adj
+                if (r == 1 || r == 7) {
+                    auto xi = Split(p).xi;  // xi or xi^adj
                     if (!Dividable(num, xi)) { xi.Adj2Inplace(); }
                     assert(Dividable(num, xi));
                     for (auto j = 0u; j < n / 2; ++j) { t *= CD2(D2(xi.Int(), xi.Sqrt())); }
-                } else if (r == 3) {
-                    // u^2 + 2 = 0 mod p
-                    // x = gcd (xi, u + i \sqrt{2})
-                    const auto u = SqrtMod(p - 2, p);
-                    const auto x = ToCD2(EuclidGCD(p, ZOmega(u, 1, 0, 1)));
+                } else if (r == 3 || r == 5) {
+                    const auto x = Split(p).x;
                     for (auto j = 0u; j < n / 2; ++j) { t *= x; }
-                } else if (r == 5) {
-                    // u^2 + 1 = 0 mod p
-                    // x = gcd (xi, u + i)
-                    const auto u = SqrtMod(p - 1, p);
-                    const auto x = ToCD2(EuclidGCD(p, ZOmega(u, 0, 1, 0)));
-                    for (auto j = 0u; j < n / 2; ++j) { t *= x; }
-                } else if (r == 7) {
-                    // r^2 = 2 mod p
-                    // xi = gcd(p, r + \sqrt{2})
-                    const auto r = SqrtMod(2, p);
-                    auto xi = EuclidGCD(p, Z2(r, 1));  // xi or xi^adj
-                    if (!Dividable(num, xi)) { xi.Adj2Inplace(); }
-                    assert(Dividable(num, xi));
-                    for (auto j = 0u; j < n / 2; ++j) { t *= CD2(D2(xi.Int(), xi.Sqrt())); }
                 } else {
                     // p = 2
                     for (auto j = 0u; j < n; ++j) { t *= Delta; }
@@ -149,17 +374,10 @@ bool Diophantine::Solve(const D2& g, CD2& t) const {
             }
 
             if (r == 1) {
-                // r^2 = 2 mod p
-                // xi = gcd(p, r + \sqrt{2})
-                // u^2 + 1 = 0 mod p
-                // x = gcd (xi, u + i)
-                const auto r = SqrtMod(2, p);
-                auto xi = EuclidGCD(p, Z2(r, 1));  // xi or xi^adj
-                if (!Dividable(num, xi)) { xi.Adj2Inplace(); }
-                assert(Dividable(num, xi));
-                const auto u = SqrtMod(p - 1, p);
-                const auto x = ToCD2(
-                    EuclidGCD(ZOmega(xi.Int(), xi.Sqrt(), 0, -xi.Sqrt()), ZOmega(u, 0, 1, 0)));
+                const auto split = Split(p);
+                const auto adj = !Dividable(num, split.xi);  // xi or xi^adj
+                assert(Dividable(num, adj ? split.xi.Adj2() : split.xi));
+                const auto x = adj ? split.x_adj2 : split.x;
                 for (auto j = 0u; j < n; ++j) { t *= x; }
             } else if (r == 3) {
                 assert(0 && "Unreachable");
@@ -173,12 +391,6 @@ bool Diophantine::Solve(const D2& g, CD2& t) const {
             }
         }
 
-#ifdef QROT_VERBOSE
-        std::cout << "g = " << g << ", norm = " << g.Norm() << std::endl;
-        std::cout << "t = " << t << std::endl;
-        std::cout << "t * t^adj = " << t * t.Adj() << ", norm = " << t.Norm().Norm() << std::endl;
-        std::cout << "xi = " << num << std::endl;
-#endif
         t.RealMut().IntMut() >>= (den_exp / 2);
         t.RealMut().SqrtMut() >>= (den_exp / 2);
         t.ImagMut().IntMut() >>= (den_exp / 2);
@@ -193,56 +405,180 @@ bool Diophantine::Solve(const D2& g, CD2& t) const {
 
     return g == t.Norm();
 }
+Diophantine::SplitPrime Diophantine::Split(const Integer& p) const {
+    if (auto cached = split_prime_cache_.Get(p)) { return *cached; }
+
+    auto split = SplitPrime();
+    const auto r = static_cast<Integer>(p % 8);
+    if (r == 1 || r == 7) {
+        // r^2 = 2 mod p
+        // xi = gcd(p, r + \sqrt{2})
+        const auto r = SqrtMod(2, p);
+        split.xi = EuclidGCD(p, Z2(r, 1));
+    }
+    if (r == 1) {
+        // u^2 + 1 = 0 mod p
+        // x = gcd (xi, u + i)
+        const auto u = SqrtMod(p - 1, p);
+        const auto& xi = split.xi;
+        split.x = ToCD2(EuclidGCD(ZOmega(xi.Int(), xi.Sqrt(), 0, -xi.Sqrt()), ZOmega(u, 0, 1, 0)));
+        split.x_adj2 =
+            ToCD2(EuclidGCD(ZOmega(xi.Int(), -xi.Sqrt(), 0, xi.Sqrt()), ZOmega(u, 0, 1, 0)));
+    } else if (r == 3) {
+        // u^2 + 2 = 0 mod p
+        // x = gcd (xi, u + i \sqrt{2})
+        const auto u = SqrtMod(p - 2, p);
+        split.x = ToCD2(EuclidGCD(p, ZOmega(u, 1, 0, 1)));
+    } else if (r == 5) {
+        // u^2 + 1 = 0 mod p
+        // x = gcd (xi, u + i)
+        const auto u = SqrtMod(p - 1, p);
+        split.x = ToCD2(EuclidGCD(p, ZOmega(u, 0, 1, 0)));
+    }
+    split_prime_cache_.Put(p, split);
+    return split;
+}
 void Diophantine::FactorizeIntoPrime(Integer n,
                                      std::unordered_map<Integer, std::uint32_t>& fac) const {
-    // Factorize into small primes
-    for (const auto& p : primes_) {
-        auto exponent = std::uint32_t{0};
-        auto q = Integer();
-        auto r = Integer();
-        mp::divide_qr(n, p, q, r);
-        while (r == 0) {
-            n = q;
-            exponent++;
-            mp::divide_qr(n, p, q, r);
+    auto ns = std::vector<Integer>{std::move(n)};
+    auto facs = std::vector<std::unordered_map<Integer, std::uint32_t>>();
+    FactorizeIntoSmallPrime(ns, facs);
+    for (const auto& [p, e] : facs.front()) { fac[p] = e; }
+    FactorizeIntoLargePrime(ns.front(), fac);
+}
+void Diophantine::FactorizeIntoPrime(
+    std::vector<Integer> ns, std::vector<std::unordered_map<Integer, std::uint32_t>>& facs) const {
+    QROT_TRACE_SCOPE("Diophantine::FactorizeIntoPrime");
+    FactorizeIntoSmallPrime(ns, facs);
+    for (auto i = std::size_t{0}; i < ns.size(); ++i) { FactorizeIntoLargePrime(ns[i], facs[i]); }
+}
+void Diophantine::FactorizeIntoSmallPrime(
+    std::vector<Integer>& ns, std::vector<std::unordered_map<Integer, std::uint32_t>>& facs) const {
+    QROT_TRACE_SCOPE("Diophantine::FactorizeIntoSmallPrime");
+    facs.assign(ns.size(), {});
+    if (ns.empty()) { return; }
+
+    // The remainder tree costs about the same for any small batch because of the size of
+    // `prime_tree_`, whereas direct remainders cost O(bits * primes_.size()) with a small constant
+    auto bits = std::size_t{0};
+    for (const auto& n : ns) { bits += n > 1 ? mp::msb(n) + 1 : 0; }
+    if (bits <= MaxDirectRemainderBits) {
+        for (auto i = std::size_t{0}; i < ns.size(); ++i) {
+            if (ns[i] > 1) { FactorizeIntoSmallPrimeDirect(ns[i], facs[i]); }
+        }
+        return;
+    }
+
+    // 0 and 1 have no prime factor to extract and are replaced by 1, which keeps the product
+    // positive
+    auto positive = std::vector<Integer>();
+    positive.reserve(ns.size());
+    for (const auto& n : ns) { positive.emplace_back(n > 1 ? n : Integer(1)); }
+    const auto tree = ProductTree(std::move(positive));
+    const auto& leaves = tree.front();
+
+    // Division of Integer is quadratic, so the remainder tree is cheapest when the nodes of
+    // `prime_tree_` are about twice as large as the product of `ns`
+    const auto product_bits = mp::msb(tree.back().front()) + 1;
+    auto level = std::size_t{0};
+    while (level + 1 < prime_tree_.size() &&
+           mp::msb(prime_tree_[level].front()) < 2 * product_bits) {
+        ++level;
+    }
+    const auto span = PrimesPerChunk << level;
+
+    auto rems = std::vector<Integer>();
+    for (auto k = std::size_t{0}; k < prime_tree_[level].size(); ++k) {
+        // rems[i] = prime_tree_[level][k] mod ns[i]
+        RemainderTree(prime_tree_[level][k], tree, rems);
+        for (auto i = std::size_t{0}; i < ns.size(); ++i) {
+            if (leaves[i] == 1) { continue; }
+            // g = product of primes in the node dividing ns[i]
+            auto g = static_cast<Integer>(mp::gcd(rems[i], leaves[i]));
+            if (g == 1) { continue; }
+
+            const auto end = std::min((k + 1) * span, primes_.size());
+            for (auto idx = k * span; idx < end && g != 1; ++idx) {
+                const auto& p = primes_[idx];
+                if (g % p != 0) { continue; }
+                g /= p;
+                facs[i][p] = DivideOut(ns[i], p);
+            }
+        }
+    }
+}
+void Diophantine::FactorizeIntoSmallPrimeDirect(
+    Integer& n, std::unordered_map<Integer, std::uint32_t>& fac) const {
+    // p divides the cofactor iff it divides the original n, so the chunks are taken only once
+    // mp::export_bits supports cpp_int only, so the chunks are taken 64 bits at a time from the
+    // least significant one. Leading zero chunks leave the remainders unchanged
+    constexpr auto Mask = std::numeric_limits<std::uint64_t>::max();
+    const auto words = static_cast<std::size_t>(mp::msb(n)) / 64 + 1;
+    auto chunks = std::vector<std::uint16_t>(4 * words);
+    auto rest = n;
+    for (auto it = chunks.rbegin(); it != chunks.rend(); rest >>= 64) {
+        auto word = static_cast<std::uint64_t>(Integer(rest & Mask));
+        for (auto i = 0; i < 4; ++i, ++it, word >>= 16) { *it = static_cast<std::uint16_t>(word); }
+    }
+    auto rems = std::array<double, RemainderBlockSize>();
+    const auto remainders = SmallPrimeRemainders.Get();
+    for (auto begin = std::size_t{0}; begin < primes_.size() && n != 1;
+         begin += RemainderBlockSize) {
+        const auto size = std::min(RemainderBlockSize, primes_.size() - begin);
+        remainders(chunks, prime_values_.data() + begin, inv_primes_.data() + begin, size,
+                   rems.data());
+        for (auto i = std::size_t{0}; i < size; ++i) {
+            if (rems[i] != 0) { continue; }
+            const auto& p = primes_[begin + i];
+            fac[p] = DivideOut(n, p);
         }
-        if (exponent != 0) { fac[p] = exponent; }
     }
-    if (n == 1) { return; }
+}
+std::size_t Diophantine::FactorizeIntoLargePrime(
+    const Integer& n, std::unordered_map<Integer, std::uint32_t>& fac) const {
+    if (n <= 1) { return 0; }
+    QROT_TRACE_SCOPE("Diophantine::FactorizeIntoLargePrime");
 
-    // Factorize into large primes
+    auto failures = std::size_t{0};
     auto queue = std::queue<Integer>();
     queue.push(n);
     while (!queue.empty()) {
         auto& n = queue.front();
         auto p = Integer{};
-        const auto success = PollardRho(n, p);
+        // Pollard-Rho algorithm never succeeds for primes
+        const auto is_prime = mp::miller_rabin_test(n, MillerRabinTrials);
+        const auto success = !is_prime && PollardRho(n, p);
         if (success) {
             n /= p;
             queue.push(p);
         } else {
+            if (!is_prime) { failures++; }
             fac[n]++;
             queue.pop();
         }
     }
+    return failures;
 }
 bool Diophantine::PollardRho(const Integer& n, Integer& p) const {
     // Assert: n is large (n >= 100)
-    constexpr auto MaxLoops = std::uint32_t{10'000};
-    // TODO: Use OpenMP
-    for (auto offset = Integer{1}; offset < 100; ++offset) {
-        const auto f = [&n, offset](const auto& x) { return ((x * x) + offset) % n; };
-
-        auto x = Integer{2};
-        auto y = Integer{2};
-        for (auto i = std::uint32_t{0}; i < MaxLoops; ++i) {
-            x = f(x);
-            y = f(f(y));
-            if (x == y) { break; }  // Find circuit
-            p = mp::gcd(n, mp::abs(x - y));
-            if (p > 1) { return true; }
+    QROT_TRACE_SCOPE("Diophantine::PollardRho");
+    auto stop = std::stop_source();
+    auto mtx = std::mutex();
+    pollard_rho_pool_.Run([&](std::uint32_t index, std::uint32_t count) {
+        for (auto offset = index + 1; offset <= PollardRhoOffsets; offset += count) {
+            auto divisor = Integer{};
+            if (!PollardBrent(n, offset, stop.get_token(), divisor)) {
+                if (stop.stop_requested()) { return; }
+                continue;
+            }
+            const auto lock = std::lock_guard(mtx);
+            if (!stop.stop_requested()) {
+                p = divisor;
+                stop.request_stop();
+            }
+            return;
         }
-    }
-    return false;
+    });
+    return stop.stop_requested();
 }
 }  // namespace qrot
@@ -1,13 +1,28 @@
 #ifndef QROT_DIOPHANTINE_H
 #define QROT_DIOPHANTINE_H
 
+#include <cstdint>
+#include <utility>
 #include <vector>
 
+#include "qrot/cache.h"
 #include "qrot/number.h"
+#include "qrot/thread_pool.h"
 
 namespace qrot {
 class Diophantine {
 public:
+    /**
+     * @brief Counters accumulated by SolveFirst.
+     */
+    struct Stats {
+        std::size_t tried = 0;                   //!< Candidates whose equation was examined
+        std::size_t rejected = 0;                //!< Examined candidates without solution
+        std::size_t cache_hits = 0;              //!< Factorizations taken from the cache
+        std::size_t factorization_failures = 0;  //!< Composite factors left unsplit
+        std::size_t max_norm_bits = 0;           //!< Largest norm to be factorized
+    };
+
     Diophantine();
 
     /**
@@ -19,6 +34,29 @@ public:
      * @return false Cannot find solution
      */
     bool Solve(const D2& g, CD2& t) const;
+    /**
+     * @brief Solve diophantine equations t^adj * t = g for candidates `gs` in order.
+     * @details Small prime factors of the candidates are extracted together with a remainder tree,
+     * so trial division is amortized over chunks of candidates, each twice as large as the last.
+     * Candidates that fail the rough check on their small prime factors are rejected before large
+     * primes are factorized.
+     *
+     * @param gs inputs
+     * @param t output (solution for the first solvable input)
+     * @return index of the first solvable input, or gs.size() if there is none
+     */
+    std::size_t SolveFirst(const std::vector<D2>& gs, CD2& t) const;
+    /**
+     * @brief SolveFirst which also accumulates counters into `stats`.
+     */
+    std::size_t SolveFirst(const std::vector<D2>& gs, CD2& t, Stats& stats) const;
+    /**
+     * @brief Write g = num / \sqrt{2}^den_exp with num in Z[\sqrt{2}] and even den_exp.
+     * @details Solve factorizes the norm of num.
+     *
+     * @return {num, den_exp}
+     */
+    static std::pair<Z2, std::int32_t> Numerator(const D2& g);
     /**
      * @brief Calculate prime factorization.
      *
@@ -26,11 +64,93 @@ public:
      * @param fac factorization map (key: prime, value: exponent)
      */
     void FactorizeIntoPrime(Integer n, std::unordered_map<Integer, std::uint32_t>& fac) const;
+    /**
+     * @brief Calculate prime factorizations of several integers at once.
+     *
+     * @param ns inputs
+     * @param facs factorization maps (one for each input)
+     */
+    void FactorizeIntoPrime(std::vector<Integer> ns,
+                            std::vector<std::unordered_map<Integer, std::uint32_t>>& facs) const;
+    /**
+     * @brief Drop cached factorizations and split primes.
+     */
+    void ClearCache() {
+        factorization_cache_.Clear();
+        split_prime_cache_.Clear();
+    }
 
 private:
+    static constexpr auto PrimesPerChunk = std::size_t{16};
+    /// Number of candidates SolveFirst factorizes together first (doubled for each later chunk)
+    static constexpr auto FirstChunkSize = std::size_t{32};
+    /// Number of primes whose remainders FactorizeIntoSmallPrimeDirect computes at once
+    static constexpr auto RemainderBlockSize = std::size_t{256};
+    /// Largest total bit length of a batch factorized by FactorizeIntoSmallPrimeDirect
+    static constexpr auto MaxDirectRemainderBits = std::size_t{4096};
+    static constexpr auto PrimeTreeHeight = std::size_t{7};
+    static constexpr auto FactorizationCacheCapacity = std::size_t{1} << 12;
+    static constexpr auto SplitPrimeCacheCapacity = std::size_t{1} << 14;
+    /// Offsets of f(x) = x^2 + offset tried by PollardRho
+    static constexpr auto PollardRhoOffsets = std::uint32_t{99};
+
+    /**
+     * @brief Factors of a prime p in Z[\sqrt{2}] and Z[\omega].
+     */
+    struct SplitPrime {
+        /// p = xi * xi^adj2 up to unit (p = 1, 7 mod 8)
+        Z2 xi = Z2();
+        /// p = x * x^adj up to unit (p = 3, 5 mod 8), or xi = x * x^adj up to unit (p = 1 mod 8)
+        CD2 x = CD2();
+        /// xi^adj2 = x_adj2 * x_adj2^adj up to unit (p = 1 mod 8)
+        CD2 x_adj2 = CD2();
+    };
+
+    /**
+     * @brief Extract prime factors in `primes_` from every element of `ns`.
+     * @details Based on Bernstein's batch factorization: the remainders of each node of
+     * `prime_tree_` modulo all of `ns` are computed with a remainder tree of `ns`, and only the
+     * primes of nodes sharing a factor with n are trial-divided. Batches of at most
+     * `MaxDirectRemainderBits` bits in total are passed to FactorizeIntoSmallPrimeDirect instead.
+     * Each element of `ns` is replaced by its cofactor.
+     */
+    void FactorizeIntoSmallPrime(std::vector<Integer>& ns,
+                                 std::vector<std::unordered_map<Integer, std::uint32_t>>& facs) const;
+    /**
+     * @brief Extract prime factors in `primes_` from `n` by computing n mod p for every prime.
+     * @details Remainders of a block of primes are computed at once in double, and only the primes
+     * with a zero remainder are divided in Integer. `n` is replaced by its cofactor.
+     */
+    void FactorizeIntoSmallPrimeDirect(Integer& n,
+                                       std::unordered_map<Integer, std::uint32_t>& fac) const;
+    /**
+     * @brief Factorize `n`, which has no factor in `primes_`, with Pollard-Rho algorithm.
+     *
+     * @return number of composite factors Pollard-Rho algorithm failed to split (they are
+     * registered in `fac` as primes)
+     */
+    std::size_t FactorizeIntoLargePrime(const Integer& n,
+                                        std::unordered_map<Integer, std::uint32_t>& fac) const;
+    /**
+     * @brief Construct a solution of t^adj * t = g from the prime factorization of the norm.
+     *
+     * @param g input
+     * @param num numerator of g (g = num / 2^(den_exp / 2))
+     * @param den_exp denominator exponent (even)
+     * @param fac prime factorization of num.Norm()
+     * @param t output
+     */
+    bool SolveImpl(const D2& g, const Z2& num, std::int32_t den_exp,
+                   const std::unordered_map<Integer, std::uint32_t>& fac, CD2& t) const;
+    /**
+     * @brief Get the factors of prime `p` from the cache, or calculate and cache them.
+     */
+    SplitPrime Split(const Integer& p) const;
     /**
      * @brief Implementation of Pollard-Rho algorithm.
      * @details See https://qiita.com/Kiri8128/items/eca965fe86ea5f4cbb98 for more information.
+     * Brent's variant is run for each offset of f(x) = x^2 + offset. Offsets are raced across
+     * the threads of `pollard_rho_pool_`, and the first divisor found cancels the other threads.
      *
      * @return true if n % p == 0
      * @return false if the algorithm cannot find divisor of n
@@ -38,6 +158,18 @@ private:
     bool PollardRho(const Integer& n, Integer& p) const;
 
     std::vector<Integer> primes_;
+    /// primes_ and their reciprocals in double
+    std::vector<double> prime_values_;
+    std::vector<double> inv_primes_;
+    /// prime_tree_[l][k] is the product of primes_[(PrimesPerChunk << l) * k, ...)
+    std::vector<std::vector<Integer>> prime_tree_;
+    /// Factorizations of norms. Entries of norms failing the rough check may hold only the small
+    /// prime factors, which are enough to reject them again.
+    mutable BoundedCache<Integer, std::unordered_map<Integer, std::uint32_t>> factorization_cache_{
+        FactorizationCacheCapacity};
+    mutable BoundedCache<Integer, SplitPrime> split_prime_cache_{SplitPrimeCacheCapacity};
+    /// Threads shared by all PollardRho calls (one thread per hardware thread)
+    mutable ThreadPool pollard_rho_pool_;
 };
 }  // namespace qrot
 
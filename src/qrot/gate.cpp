@@ -1,12 +1,18 @@
 #include "qrot/gate.h"
 
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
 #include <iostream>
-#include <queue>
+#include <limits>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "qrot/trace.h"
+
 namespace qrot {
 #pragma region Atom
 constexpr Atom Atom::FromChar(char c) {
@@ -59,94 +65,107 @@ std::ostream& operator<<(std::ostream& out, Atom a) { return out << a.ToChar();
 #pragma region Gate
 Gate Gate::FromString(const std::string& s) {
     auto gate = Gate();
-    gate.atoms_.resize(s.size());
-    std::transform(s.begin(), s.end(), gate.atoms_.begin(),
-                   [](const char c) { return Atom::FromChar(c); });
+    gate.Reserve(s.size());
+    for (const auto c : s) { gate *= Atom::FromChar(c); }
     return gate;
 }
-std::size_t Gate::CountT() const {
-    using constant::gate::T;
-    auto ret = std::size_t{0};
-    for (const auto atom : atoms_) { ret += (atom == T) ? 1 : 0; }
-    return ret;
-}
 std::string Gate::ToString() const {
     if (Empty()) { return "I"; }
-    auto ret = std::string();
-    ret.resize(atoms_.size());
-    std::transform(atoms_.begin(), atoms_.end(), ret.begin(),
-                   [](const Atom a) { return a.ToChar(); });
+    auto ret = std::string(size_, 'I');
+    std::transform(begin(), end(), ret.begin(), [](const Atom a) { return a.ToChar(); });
     return ret;
 }
-bool Gate::IsClifford() const {
-    using constant::gate::T;
-    return std::all_of(atoms_.begin(), atoms_.end(), [](const Atom a) { return a.IsClifford(); });
+void Gate::Write(std::ostream& out) const {
+    if (Empty()) {
+        out << 'I';
+        return;
+    }
+    auto buffer = std::array<char, 256>();
+    auto n = std::size_t{0};
+    for (const auto a : *this) {
+        buffer[n++] = a.ToChar();
+        if (n == buffer.size()) {
+            out.write(buffer.data(), static_cast<std::streamsize>(n));
+            n = 0;
+        }
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(n));
 }
 MCD2 Gate::Mat() const {
     auto ret = MCD2::Identity();
-    for (const auto a : atoms_) { ret *= a.Mat(); }
+    for (const auto a : *this) { ret *= a.Mat(); }
     return ret;
 }
 void Gate::Normalize() {
+    QROT_TRACE_SCOPE("Gate::Normalize");
     using namespace constant;
-    static CliffordDatabase database;
+    using DB = CliffordDatabase;
 
-    auto normal = std::vector<Gate>();
-    auto clifford = mcd2::I;
-    for (const auto a : atoms_) {
+    // The normal form is [T] (H T | SH T)* C
+    auto normal = Gate();
+    normal.Reserve(size_);
+    auto clifford = DB::IdentityIndex;
+    for (const auto a : *this) {
         if (a == gate::T) {
-            const auto index = database.SearchIndex(clifford);
-            const auto move = database.GetTMove(index);
-            switch (CliffordDatabase::GetType(index)) {
-                case CliffordDatabase::Type::CT: {
-                    if (!normal.empty() && normal.back() == gate::T) {
-                        normal.pop_back();
-                        if (!normal.empty()) {
-                            clifford = normal.back().Mat() * mcd2::S * database.GetMatrix(move);
-                            normal.pop_back();
-                        } else {
-                            clifford = mcd2::S * database.GetMatrix(move);
+            const auto move = DB::GetTMove(clifford);
+            switch (DB::GetType(clifford)) {
+                case DB::Type::CT: {
+                    if (!normal.Empty() && normal.Back() == gate::T) {
+                        normal.PopBack();
+                        auto prefix = DB::IdentityIndex;
+                        if (!normal.Empty()) {
+                            // Pop the syllable H or SH
+                            assert(normal.Back() == gate::H);
+                            normal.PopBack();
+                            if (!normal.Empty() && normal.Back() == gate::S) {
+                                normal.PopBack();
+                                prefix = DB::Multiply(prefix, gate::S);
+                            }
+                            prefix = DB::Multiply(prefix, gate::H);
                         }
+                        clifford = DB::Multiply(DB::Multiply(prefix, gate::S), move);
                     } else {
-                        normal.emplace_back(gate::T);
-                        clifford = database.GetMatrix(move);
+                        normal *= gate::T;
+                        clifford = move;
                     }
                     break;
                 }
-                case CliffordDatabase::Type::HCT: {
-                    normal.emplace_back(gate::H);
-                    normal.emplace_back(gate::T);
-                    clifford = database.GetMatrix(move);
+                case DB::Type::HCT: {
+                    normal *= gate::H;
+                    normal *= gate::T;
+                    clifford = move;
                     break;
                 }
-                case CliffordDatabase::Type::SHCT: {
-                    normal.emplace_back(gate::S * gate::H);
-                    normal.emplace_back(gate::T);
-                    clifford = database.GetMatrix(move);
+                case DB::Type::SHCT: {
+                    normal *= gate::S;
+                    normal *= gate::H;
+                    normal *= gate::T;
+                    clifford = move;
                     break;
                 }
-                case CliffordDatabase::Type::NotClifford:
-                    throw std::logic_error("clifford is not Clifford");
+                case DB::Type::NotClifford: throw std::logic_error("clifford is not Clifford");
             }
         } else {
-            clifford *= a.Mat();
+            clifford = DB::Multiply(clifford, a);
         }
     }
-    if (clifford != mcd2::I) {
-        normal.emplace_back(database.GetGate(database.SearchIndex(clifford)));
-    }
+    if (clifford != DB::IdentityIndex) { normal *= DB::GetGate(clifford); }
 
-    atoms_.clear();
-    for (const auto& gate : normal) {
-        for (const auto atom : gate) { atoms_.emplace_back(atom); }
+    *this = std::move(normal);
+}
+void Gate::PopBack() {
+    using constant::gate::T;
+    if (Back() == T) { t_count_--; }
+    size_--;
+    const auto shift = BitsPerAtom * (size_ % AtomsPerWord);
+    if (shift == 0) {
+        words_.pop_back();
+    } else {
+        words_.back() &= ~(AtomMask << shift);
     }
 }
 bool operator==(const Gate& lhs, const Gate& rhs) {
-    if (lhs.Size() != rhs.Size()) { return false; }
-    for (auto i = std::size_t{0}; i < lhs.Size(); ++i) {
-        if (lhs.Get(i) != rhs.Get(i)) { return false; }
-    }
-    return true;
+    return lhs.size_ == rhs.size_ && lhs.words_ == rhs.words_;
 }
 bool operator==(const Gate& lhs, const Atom& rhs) { return lhs.Size() == 1 && lhs.Get(0) == rhs; }
 bool operator==(const Atom& lhs, const Gate& rhs) { return rhs.Size() == 1 && rhs.Get(0) == lhs; }
@@ -154,99 +173,326 @@ bool operator!=(const Gate& lhs, const Gate& rhs) { return !(lhs == rhs); }
 bool operator!=(const Gate& lhs, const Atom& rhs) { return !(lhs == rhs); }
 bool operator!=(const Atom& lhs, const Gate& rhs) { return !(lhs == rhs); }
 Gate& Gate::operator*=(Atom a) {
-    atoms_.emplace_back(a);
+    const auto shift = BitsPerAtom * (size_ % AtomsPerWord);
+    if (shift == 0) { words_.emplace_back(0); }
+    words_.back() |= static_cast<std::uint64_t>(a.GetType()) << shift;
+    size_++;
+    if (!a.IsClifford()) { t_count_++; }
     return *this;
 }
 Gate& Gate::operator*=(const Gate& g) {
-    const auto tmp_size = atoms_.size();
-    atoms_.resize(tmp_size + g.Size());
-    std::copy(g.begin(), g.end(), atoms_.begin() + tmp_size);
+    if (this == &g) { return *this *= Gate(g); }
+    if (size_ % AtomsPerWord == 0) {
+        // Aligned: copy packed words directly
+        words_.insert(words_.end(), g.words_.begin(), g.words_.end());
+        size_ += g.size_;
+        t_count_ += g.t_count_;
+        return *this;
+    }
+    for (const auto a : g) { *this *= a; }
     return *this;
 }
-std::ostream& operator<<(std::ostream& out, const Gate& g) { return out << g.ToString(); }
+std::ostream& operator<<(std::ostream& out, const Gate& g) {
+    g.Write(out);
+    return out;
+}
 Gate operator*(Atom l, Atom r) {
     auto ret = Gate(l);
     return ret *= r;
 }
 Gate operator*(const Gate& l, Atom r) {
-    // TODO: Implement more efficiently
-    auto ret = Gate(l);
+    auto ret = Gate();
+    ret.Reserve(l.Size() + 1);
+    ret *= l;
     return ret *= r;
 }
+Gate operator*(Gate&& l, Atom r) { return std::move(l *= r); }
 Gate operator*(Atom l, const Gate& r) {
-    // TODO: Implement more efficiently
-    auto ret = Gate(l);
+    auto ret = Gate();
+    ret.Reserve(r.Size() + 1);
+    ret *= l;
     return ret *= r;
 }
 Gate operator*(const Gate& l, const Gate& r) {
-    // TODO: Implement more efficiently
-    auto ret = Gate(l);
+    auto ret = Gate();
+    ret.Reserve(l.Size() + r.Size());
+    ret *= l;
     return ret *= r;
 }
+Gate operator*(Gate&& l, const Gate& r) { return std::move(l *= r); }
 #pragma endregion Gate
 #pragma region CliffordDatabase
-CliffordDatabase::CliffordDatabase() {
-    using namespace constant;
+namespace {
+/**
+ * @brief Clifford matrix encoded as (1/\sqrt{2})^scale * [omega^exp[i]] (exp[i] == Zero means 0).
+ * @details Every element of the clifford group (including global phases) has this form.
+ */
+struct SmallMatrix {
+    static constexpr auto Zero = std::uint8_t{8};
 
-    // Calculate C_T of 0806.3834
-    auto queue = std::queue<std::pair<MCD2, Gate>>();
-    auto database = std::vector<std::pair<MCD2, Gate>>();
-    const auto pushed = [&database](const MCD2& m) {
-        return std::find_if(database.begin(), database.end(),
-                            [&m](const auto& entry) { return entry.first == m; }) != database.end();
-    };
-    // Initialize
-    queue.push({mcd2::I, Gate()});
-    database.emplace_back(mcd2::I, Gate());
-    // BFS
-    while (!queue.empty()) {
-        const auto [m, g] = queue.front();
-        queue.pop();
-        {
-            const auto n = m * mcd2::S;
-            if (!pushed(n)) {
-                queue.push({n, g * gate::S});
-                database.emplace_back(n, g * gate::S);
+    std::array<std::uint8_t, 4> exp;
+    std::uint8_t scale;
+};
+constexpr auto NumAtomTypes = std::size_t{8};
+constexpr auto NotFound = std::numeric_limits<std::uint8_t>::max();
+
+constexpr SmallMatrix Mul(const SmallMatrix& lhs, const SmallMatrix& rhs) {
+    constexpr auto Zero = std::int32_t{SmallMatrix::Zero};
+    auto ret = SmallMatrix{{Zero, Zero, Zero, Zero}, 0};
+    auto scale = -1;
+    for (auto i = std::size_t{0}; i < 2; ++i) {
+        for (auto j = std::size_t{0}; j < 2; ++j) {
+            // (L R)_ij = (1/\sqrt{2})^{lhs.scale + rhs.scale} (omega^x + omega^y)
+            //         = (1/\sqrt{2})^{lhs.scale + rhs.scale - m} omega^e
+            const auto x = lhs.exp[2 * i] == Zero || rhs.exp[j] == Zero
+                               ? Zero
+                               : (lhs.exp[2 * i] + rhs.exp[j]) % 8;
+            const auto y = lhs.exp[2 * i + 1] == Zero || rhs.exp[2 + j] == Zero
+                               ? Zero
+                               : (lhs.exp[2 * i + 1] + rhs.exp[2 + j]) % 8;
+            auto e = Zero;
+            auto m = 0;
+            if (x == Zero || y == Zero) {
+                e = x == Zero ? y : x;
+            } else {
+                switch ((y + 8 - x) % 8) {
+                    case 0:  // 2 omega^x
+                        e = x;
+                        m = 2;
+                        break;
+                    case 2:  // (1 + i) omega^x
+                        e = (x + 1) % 8;
+                        m = 1;
+                        break;
+                    case 4: e = Zero; break;
+                    case 6:  // (1 - i) omega^x
+                        e = (x + 7) % 8;
+                        m = 1;
+                        break;
+                    default: throw std::logic_error("Product is not in the clifford group");
+                }
             }
-        }
-        {
-            const auto n = m * mcd2::X;
-            if (!pushed(n)) {
-                queue.push({n, g * gate::X});
-                database.emplace_back(n, g * gate::X);
+            ret.exp[2 * i + j] = static_cast<std::uint8_t>(e);
+            if (e == Zero) { continue; }
+            const auto s = lhs.scale + rhs.scale - m;
+            if (s < 0 || 1 < s || (scale >= 0 && scale != s)) {
+                throw std::logic_error("Product is not in the clifford group");
             }
+            scale = s;
         }
-        {
-            const auto n = m * mcd2::W;
-            if (!pushed(n)) {
-                queue.push({n, g * gate::W});
-                database.emplace_back(n, g * gate::W);
-            }
+    }
+    ret.scale = static_cast<std::uint8_t>(scale);
+    return ret;
+}
+constexpr SmallMatrix Diag(std::uint8_t e0, std::uint8_t e1) {
+    return {{e0, SmallMatrix::Zero, SmallMatrix::Zero, e1}, 0};
+}
+constexpr SmallMatrix AntiDiag(std::uint8_t e0, std::uint8_t e1) {
+    return {{SmallMatrix::Zero, e0, e1, SmallMatrix::Zero}, 0};
+}
+constexpr SmallMatrix AtomMatrix(Atom::Type t) {
+    switch (t) {
+        case Atom::Type::I: return Diag(0, 0);
+        case Atom::Type::H: return {{0, 0, 0, 4}, 1};
+        case Atom::Type::S: return Diag(0, 2);
+        case Atom::Type::T: return Diag(0, 1);
+        case Atom::Type::X: return AntiDiag(0, 0);
+        case Atom::Type::Y: return AntiDiag(6, 2);
+        case Atom::Type::Z: return Diag(0, 4);
+        case Atom::Type::W: return Diag(1, 1);
+    }
+    return {};
+}
+constexpr std::uint32_t Key(const SmallMatrix& m) {
+    auto key = std::uint32_t{m.scale};
+    for (const auto e : m.exp) { key = (key << 4) | e; }
+    return key;
+}
+struct CliffordTables {
+    static constexpr auto NumElements = CliffordDatabase::NumElements;
+    static constexpr auto NumCT = CliffordDatabase::NumCT;
+    static constexpr auto MaxWordLength = CliffordDatabase::MaxWordLength;
+
+    std::array<SmallMatrix, NumElements> mat;
+    std::array<std::uint32_t, NumElements> key;
+    std::array<std::array<Atom, MaxWordLength>, NumElements> word;
+    std::array<std::uint8_t, NumElements> word_size;
+    std::array<std::array<std::uint8_t, NumAtomTypes>, NumElements> mul_atom;  // C_i * atom
+    std::array<std::array<std::uint8_t, NumElements>, NumElements> mul;        // C_i * C_j
+    std::array<std::uint8_t, NumCT> move;                                      // TDag C_T T
+
+    // Open addressing hash table (key -> index) used only during generation
+    static constexpr auto HashSize = std::size_t{512};
+    std::array<std::uint8_t, HashSize> hash;
+
+    static constexpr std::size_t Hash(std::uint32_t k) {
+        return static_cast<std::size_t>((k * 0x9E3779B1u) >> 23);
+    }
+    constexpr std::size_t Find(std::uint32_t k) const {
+        for (auto h = Hash(k); hash[h] != NotFound; h = (h + 1) % HashSize) {
+            if (key[hash[h]] == k) { return hash[h]; }
         }
+        return NotFound;
+    }
+    constexpr void Push(std::size_t idx, const SmallMatrix& m, Atom prefix1, Atom prefix2,
+                        std::size_t src, Atom suffix) {
+        // word[idx] = prefix1 prefix2 word[src] suffix (I is skipped)
+        mat[idx] = m;
+        key[idx] = Key(m);
+        auto h = Hash(key[idx]);
+        while (hash[h] != NotFound) { h = (h + 1) % HashSize; }
+        hash[h] = static_cast<std::uint8_t>(idx);
+        auto size = std::size_t{0};
+        const auto push_atom = [this, idx, &size](Atom a) {
+            if (a == Atom::I()) { return; }
+            if (size >= MaxWordLength) { throw std::logic_error("Too long clifford word"); }
+            word[idx][size++] = a;
+        };
+        push_atom(prefix1);
+        push_atom(prefix2);
+        for (auto i = std::size_t{0}; i < word_size[src]; ++i) { push_atom(word[src][i]); }
+        push_atom(suffix);
+        word_size[idx] = static_cast<std::uint8_t>(size);
     }
+};
+constexpr CliffordTables GenerateCliffordTables() {
+    using Type = Atom::Type;
+    constexpr auto NumElements = CliffordTables::NumElements;
+    constexpr auto NumCT = CliffordTables::NumCT;
+    constexpr auto I = Atom::I(), H = Atom::H(), S = Atom::S();
+    constexpr auto Index = [](Type t) { return static_cast<std::size_t>(t); };
 
-    // Add prefix H
-    for (auto i = std::size_t{0}; i < NumCT; ++i) {
-        const auto& [m, g] = database[i];
-        assert(!pushed(mcd2::H * m));
-        database.emplace_back(mcd2::H * m, gate::H * g);
+    auto tables = CliffordTables{};
+    for (auto& h : tables.hash) { h = NotFound; }
+
+    // Calculate C_T of 0806.3834 by BFS (the table itself is used as a queue)
+    // C_idx = C_parent[idx] * last[idx]
+    auto parent = std::array<std::size_t, NumCT>{};
+    auto last = std::array<Type, NumCT>{};
+    tables.Push(0, AtomMatrix(Type::I), I, I, 0, I);
+    auto size = std::size_t{1};
+    for (auto head = std::size_t{0}; head < size; ++head) {
+        for (const auto t : {Type::S, Type::X, Type::W}) {
+            const auto n = Mul(tables.mat[head], AtomMatrix(t));
+            if (tables.Find(Key(n)) != NotFound) { continue; }
+            if (size >= NumCT) { throw std::logic_error("C_T must have 64 elements"); }
+            parent[size] = head;
+            last[size] = t;
+            tables.Push(size++, n, I, I, head, Atom(t));
+        }
     }
-    // Add prefix SH
+    if (size != NumCT) { throw std::logic_error("C_T must have 64 elements"); }
+
+    // Add prefix H and SH
+    const auto h = AtomMatrix(Type::H);
+    const auto sh = Mul(AtomMatrix(Type::S), h);
     for (auto i = std::size_t{0}; i < NumCT; ++i) {
-        const auto& [m, g] = database[i];
-        assert(!pushed(mcd2::S * mcd2::H * m));
-        database.emplace_back(mcd2::S * mcd2::H * m, gate::S * gate::H * g);
+        tables.Push(NumCT + i, Mul(h, tables.mat[i]), I, H, i, I);
+        tables.Push(2 * NumCT + i, Mul(sh, tables.mat[i]), S, H, i, I);
+    }
+
+    // Right multiplication by clifford atoms
+    for (auto i = std::size_t{0}; i < NumElements; ++i) {
+        for (auto t = std::size_t{0}; t < NumAtomTypes; ++t) {
+            const auto type = static_cast<Type>(t);
+            if (type == Type::T) {
+                tables.mul_atom[i][t] = NotFound;
+                continue;
+            }
+            const auto idx = tables.Find(Key(Mul(tables.mat[i], AtomMatrix(type))));
+            if (idx == NotFound) { throw std::logic_error("Clifford group is not closed"); }
+            tables.mul_atom[i][t] = static_cast<std::uint8_t>(idx);
+        }
+    }
+
+    // Cayley table
+    for (auto i = std::size_t{0}; i < NumElements; ++i) {
+        // C_i C_j = (C_i C_parent[j]) last[j]
+        tables.mul[i][0] = static_cast<std::uint8_t>(i);
+        for (auto j = std::size_t{1}; j < NumCT; ++j) {
+            tables.mul[i][j] = tables.mul_atom[tables.mul[i][parent[j]]][Index(last[j])];
+        }
+    }
+    for (auto i = std::size_t{0}; i < NumElements; ++i) {
+        // C_i H C_j = (C_i H) C_j, C_i S H C_j = (C_i S H) C_j
+        const auto ih = tables.mul_atom[i][Index(Type::H)];
+        const auto ish = tables.mul_atom[tables.mul_atom[i][Index(Type::S)]][Index(Type::H)];
+        for (auto j = std::size_t{0}; j < NumCT; ++j) {
+            tables.mul[i][NumCT + j] = tables.mul[ih][j];
+            tables.mul[i][2 * NumCT + j] = tables.mul[ish][j];
+        }
     }
-    c1_.swap(database);
 
     // Calculate move of TDag C_T T
-    move_.resize(NumCT);
+    const auto t = AtomMatrix(Type::T);
+    const auto t_dag = Diag(0, 7);
     for (auto i = std::size_t{0}; i < NumCT; ++i) {
-        const auto& m = GetMatrix(i);
-        const auto n = mcd2::TDag * m * mcd2::T;
-        move_[i] = SearchIndex(n);
+        const auto idx = tables.Find(Key(Mul(Mul(t_dag, tables.mat[i]), t)));
+        if (idx == NotFound) { throw std::logic_error("TDag C_T T is not clifford"); }
+        tables.move[i] = static_cast<std::uint8_t>(idx);
     }
+
+    return tables;
 }
+constexpr auto Tables = GenerateCliffordTables();
+
+bool ToSmallMatrix(const MCD2& mat, SmallMatrix& out) {
+    // Find e such that x = omega^e, where the coefficients of x in the basis {1, omega, omega^2,
+    // omega^3} are given
+    const auto to_exp = [](const std::array<DyadicFraction, 4>& x) -> std::uint8_t {
+        auto e = SmallMatrix::Zero;
+        for (auto i = std::size_t{0}; i < 4; ++i) {
+            if (x[i] == DyadicFraction(0)) { continue; }
+            if (e != SmallMatrix::Zero) { return SmallMatrix::Zero; }
+            if (x[i] == DyadicFraction(1)) {
+                e = static_cast<std::uint8_t>(i);
+            } else if (x[i] == DyadicFraction(-1)) {
+                e = static_cast<std::uint8_t>(i + 4);
+            } else {
+                return SmallMatrix::Zero;
+            }
+        }
+        return e;
+    };
+    auto scale = -1;
+    for (auto k = std::size_t{0}; k < 4; ++k) {
+        const auto& x = mat.Get(k / 2, k % 2);
+        // x = a + \sqrt{2} b + i (c + \sqrt{2} d)
+        //   = a + (b + d) omega + c omega^2 + (d - b) omega^3
+        // \sqrt{2} x = 2b + (a + c) omega + 2d omega^2 + (c - a) omega^3
+        const auto& a = x.Real().Int();
+        const auto& b = x.Real().Sqrt();
+        const auto& c = x.Imag().Int();
+        const auto& d = x.Imag().Sqrt();
+        out.exp[k] = SmallMatrix::Zero;
+        if (x == CD2(0)) { continue; }
+        auto s = 0;
+        auto e = to_exp({a, b + d, c, d - b});
+        if (e == SmallMatrix::Zero) {
+            s = 1;
+            e = to_exp({b << 1, a + c, d << 1, c - a});
+        }
+        if (e == SmallMatrix::Zero) { return false; }
+        if (scale >= 0 && scale != s) { return false; }
+        scale = s;
+        out.exp[k] = e;
+    }
+    if (scale < 0) { return false; }
+    out.scale = static_cast<std::uint8_t>(scale);
+    return true;
+}
+MCD2 ToMCD2(const SmallMatrix& mat) {
+    using constant::cd2::InvSqrt;
+    auto entries = std::array<CD2, 4>();
+    for (auto k = std::size_t{0}; k < 4; ++k) {
+        const auto e = mat.exp[k];
+        if (e == SmallMatrix::Zero) { continue; }
+        entries[k] = ToCD2(Pow(constant::zom::Omega, e));
+        if (mat.scale != 0) { entries[k] *= InvSqrt; }
+    }
+    return MCD2(entries[0], entries[1], entries[2], entries[3]);
+}
+}  // namespace
 CliffordDatabase::Type CliffordDatabase::GetType(std::size_t idx) {
     if (idx < NumCT) {
         return Type::CT;
@@ -257,12 +503,30 @@ CliffordDatabase::Type CliffordDatabase::GetType(std::size_t idx) {
     }
     return Type::NotClifford;
 }
-std::size_t CliffordDatabase::SearchIndex(const MCD2& mat) const {
-    for (auto i = std::size_t{0}; i < c1_.size(); ++i) {
-        if (mat == c1_[i].first) { return i; }
-    }
-    return std::numeric_limits<std::size_t>::max();
+std::size_t CliffordDatabase::SearchIndex(const MCD2& mat) {
+    auto small = SmallMatrix();
+    if (!ToSmallMatrix(mat, small)) { return std::numeric_limits<std::size_t>::max(); }
+    const auto idx = Tables.Find(Key(small));
+    return idx == NotFound ? std::numeric_limits<std::size_t>::max() : idx;
+}
+std::size_t CliffordDatabase::SearchIndex(const Gate& g) {
+    auto idx = IdentityIndex;
+    for (const auto a : g) { idx = Multiply(idx, a); }
+    return idx;
+}
+MCD2 CliffordDatabase::GetMatrix(std::size_t idx) { return ToMCD2(Tables.mat[idx]); }
+Gate CliffordDatabase::GetGate(std::size_t idx) {
+    auto ret = Gate();
+    for (auto i = std::size_t{0}; i < Tables.word_size[idx]; ++i) { ret *= Tables.word[idx][i]; }
+    return ret;
+}
+std::size_t CliffordDatabase::Multiply(std::size_t lhs, std::size_t rhs) {
+    return Tables.mul[lhs][rhs];
+}
+std::size_t CliffordDatabase::Multiply(std::size_t idx, Atom a) {
+    if (!a.IsClifford()) { throw std::logic_error("Atom must be Clifford"); }
+    return Tables.mul_atom[idx][static_cast<std::size_t>(a.GetType())];
 }
-std::size_t CliffordDatabase::GetTMove(std::size_t idx) const { return move_[idx % NumCT]; }
+std::size_t CliffordDatabase::GetTMove(std::size_t idx) { return Tables.move[idx % NumCT]; }
 #pragma endregion CliffordDatabase
 }  // namespace qrot
@@ -2,7 +2,10 @@
 #define QROT_GATE_H
 
 #include <compare>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <utility>
 #include <vector>
@@ -13,7 +16,7 @@ namespace qrot {
 #pragma region Atom
 class Atom {
 public:
-    enum class Type { I, H, S, T, X, Y, Z, W };
+    enum class Type : std::uint8_t { I, H, S, T, X, Y, Z, W };
 
     constexpr Atom() : t_{Type::I} {}
     explicit constexpr Atom(Type t) : t_{t} {}
@@ -50,20 +53,59 @@ static constexpr auto W = Atom::W();
 }  // namespace constant::gate
 #pragma endregion Atom
 #pragma region Gate
+/**
+ * @brief Sequence of atoms.
+ * @details Atoms are packed into 64-bit words (3 bits per atom, 21 atoms per word) and the number
+ * of T gates is cached so that `CountT` is O(1).
+ */
 class Gate {
 public:
-    using ConstIterator = std::vector<Atom>::const_iterator;
+    class ConstIterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Atom;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Atom;
+
+        ConstIterator() = default;
+        ConstIterator(const Gate* gate, std::size_t idx) : gate_{gate}, idx_{idx} {}
+
+        Atom operator*() const { return gate_->Get(idx_); }
+        ConstIterator& operator++() {
+            ++idx_;
+            return *this;
+        }
+        ConstIterator operator++(int) {
+            auto ret = *this;
+            ++idx_;
+            return ret;
+        }
+        bool operator==(const ConstIterator&) const = default;
+
+    private:
+        const Gate* gate_ = nullptr;
+        std::size_t idx_ = 0;
+    };
 
     Gate() = default;
-    explicit Gate(Atom a) : atoms_{1, a} {}
+    explicit Gate(Atom a) { *this *= a; }
     static Gate FromString(const std::string& s);
 
-    bool Empty() const { return atoms_.empty(); }
-    std::size_t Size() const { return atoms_.size(); }
-    Atom Get(std::size_t idx) const { return atoms_[idx]; }
-    std::size_t CountT() const;
+    bool Empty() const { return size_ == 0; }
+    std::size_t Size() const { return size_; }
+    Atom Get(std::size_t idx) const {
+        const auto shift = BitsPerAtom * (idx % AtomsPerWord);
+        return Atom(static_cast<Atom::Type>((words_[idx / AtomsPerWord] >> shift) & AtomMask));
+    }
+    Atom Back() const { return Get(size_ - 1); }
+    std::size_t CountT() const { return t_count_; }
     std::string ToString() const;
-    bool IsClifford() const;
+    /**
+     * @brief Write atoms to `out` without constructing an intermediate string.
+     */
+    void Write(std::ostream& out) const;
+    bool IsClifford() const { return t_count_ == 0; }
     MCD2 Mat() const;
 
     /**
@@ -71,17 +113,26 @@ public:
      * @details See https://arxiv.org/abs/0806.3834 for more information.
      */
     void Normalize();
+    void Reserve(std::size_t size) { words_.reserve((size + AtomsPerWord - 1) / AtomsPerWord); }
+    void PopBack();
 
-    ConstIterator begin() { return atoms_.begin(); }
-    ConstIterator end() { return atoms_.end(); }
-    ConstIterator begin() const { return atoms_.begin(); }
-    ConstIterator end() const { return atoms_.end(); }
+    ConstIterator begin() const { return {this, 0}; }
+    ConstIterator end() const { return {this, size_}; }
 
     Gate& operator*=(Atom a);
     Gate& operator*=(const Gate& g);
 
+    friend bool operator==(const Gate& lhs, const Gate& rhs);
+
 private:
-    std::vector<Atom> atoms_;
+    static constexpr std::size_t BitsPerAtom = 3;
+    static constexpr std::size_t AtomsPerWord = 64 / BitsPerAtom;
+    static constexpr std::uint64_t AtomMask = (std::uint64_t{1} << BitsPerAtom) - 1;
+
+    // Bits of unused atoms are always zero
+    std::vector<std::uint64_t> words_;
+    std::size_t size_ = 0;
+    std::size_t t_count_ = 0;
 };
 std::ostream& operator<<(std::ostream& out, const Gate& g);
 bool operator==(const Gate& lhs, const Gate& rhs);
@@ -92,10 +143,17 @@ bool operator!=(const Gate& lhs, const Atom& rhs);
 bool operator!=(const Atom& lhs, const Gate& rhs);
 Gate operator*(Atom l, Atom r);
 Gate operator*(const Gate& l, Atom r);
+Gate operator*(Gate&& l, Atom r);
 Gate operator*(Atom l, const Gate& r);
 Gate operator*(const Gate& l, const Gate& r);
+Gate operator*(Gate&& l, const Gate& r);
 #pragma endregion Gate
 #pragma region CliffordDatabase
+/**
+ * @brief Database of clifford group including global phases (192 elements).
+ * @details All tables are generated at compile time and shared read-only.
+ * Elements are arranged in the order C_T(C_1), H C_T(C_1), SH C_T(C_1) of 0806.3834.
+ */
 class CliffordDatabase {
 public:
     enum class Type {
@@ -105,12 +163,33 @@ public:
         NotClifford,
     };
 
-    CliffordDatabase();
+    static constexpr std::size_t NumElements = 192;
+    static constexpr std::size_t NumCT = 64;
+    static constexpr std::size_t MaxWordLength = 10;
+    static constexpr std::size_t IdentityIndex = 0;
+
+    CliffordDatabase() = default;
 
     static Type GetType(std::size_t idx);
-    std::size_t SearchIndex(const MCD2& mat) const;
-    const MCD2& GetMatrix(std::size_t idx) const { return c1_[idx].first; }
-    const Gate& GetGate(std::size_t idx) const { return c1_[idx].second; }
+    /**
+     * @brief Return the index of `mat` or std::numeric_limits<std::size_t>::max() if `mat` is not
+     * an element of the clifford group.
+     */
+    static std::size_t SearchIndex(const MCD2& mat);
+    /**
+     * @brief Return the index of Clifford gate `g`.
+     */
+    static std::size_t SearchIndex(const Gate& g);
+    static MCD2 GetMatrix(std::size_t idx);
+    static Gate GetGate(std::size_t idx);
+    /**
+     * @brief Get the index of C_lhs * C_rhs.
+     */
+    static std::size_t Multiply(std::size_t lhs, std::size_t rhs);
+    /**
+     * @brief Get the index of C_idx * a (a must be Clifford).
+     */
+    static std::size_t Multiply(std::size_t idx, Atom a);
     /**
      * @brief Get the index of T-moved gate.
      * @details
@@ -122,18 +201,7 @@ public:
      *
      * Return the index of C'
      */
-    std::size_t GetTMove(std::size_t idx) const;
-
-private:
-    static constexpr std::size_t NumElements = 192;
-    static constexpr std::size_t NumCT = 64;
-
-    /**
-     * @brief Database of clifford group.
-     * @details Elements are arranged in the order C_T(C_1), H C_T(C_1), SH C_T(C_1)
-     */
-    std::vector<std::pair<MCD2, Gate>> c1_;
-    std::vector<std::size_t> move_;  //!< Information of TDag C_T T
+    static std::size_t GetTMove(std::size_t idx);
 };
 #pragma endregion CliffordDatabase
 }  // namespace qrot
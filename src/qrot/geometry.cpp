@@ -1,5 +1,8 @@
 #include "qrot/geometry.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace qrot {
 std::pair<Float, Float> ToExponentFormat(const Float& a, const Float& d) {
     using constant::f::InvLogLambda;
@@ -73,4 +76,39 @@ BBox Ellipse::CalcBBox() const {
     }
     return bbox;
 }
+namespace {
+/**
+ * @brief Interval enclosing the range of v such that p u^2 + 2b uv + q v^2 <= s^2 (pq - b^2 = 1).
+ * @details Shared by Ellipse::YRange and Ellipse::XRange, with u and v relative to the center.
+ */
+std::optional<std::pair<Float, Float>> SliceRange(const Float& u, const Float& center,
+                                                  const Float& s, const Float& p, const Float& b,
+                                                  const Float& q) {
+    // v = (-b u +- \sqrt{q s^2 - u^2}) / q since pq - b^2 = 1
+    const auto du = static_cast<double>(u);
+    const auto ds = static_cast<double>(s);
+    const auto db = static_cast<double>(b);
+    const auto dq = static_cast<double>(q);
+    const auto qs2 = dq * ds * ds;
+    const auto disc = qs2 - du * du;
+    const auto mid = -db * du / dq;
+    // The cancellation in disc perturbs the root by at most ~2^{-25} s / \sqrt{q}
+    const auto pad = std::ldexp(ds / std::sqrt(dq) + std::abs(mid), -20);
+    if (!std::isfinite(disc) || !std::isfinite(pad)) {
+        const Float half_width = s * mp::sqrt(p);
+        return std::pair<Float, Float>{center - half_width, center + half_width};
+    }
+    if (disc < -std::ldexp(qs2, -40)) { return std::nullopt; }
+    const auto half = std::sqrt(std::max(disc, 0.0)) / dq + pad;
+    return std::pair<Float, Float>{center + (mid - half), center + (mid + half)};
+}
+}  // namespace
+std::optional<std::pair<Float, Float>> Ellipse::YRange(const Float& x) const {
+    // a u^2 + 2b uv + d v^2 <= s^2 with u = x - c_x, v = y - c_y
+    return SliceRange(x - c_.X(), c_.Y(), s_, a_, b_, d_);
+}
+std::optional<std::pair<Float, Float>> Ellipse::XRange(const Float& y) const {
+    // d u^2 + 2b uv + a v^2 <= s^2 with u = y - c_y, v = x - c_x
+    return SliceRange(y - c_.Y(), c_.X(), s_, d_, b_, a_);
+}
 }  // namespace qrot
@@ -1,6 +1,7 @@
 #ifndef QROT_GEOMETRY_H
 #define QROT_GEOMETRY_H
 
+#include <optional>
 #include <utility>
 
 #include "qrot/matrix.h"
@@ -82,6 +83,21 @@ public:
     std::pair<Float, Float> ExponentFormat() const { return ToExponentFormat(a_, d_); }
 
     BBox CalcBBox() const;
+    /**
+     * @brief Calculate an interval enclosing the range of y such that (x, y) is in the ellipse.
+     * @details Evaluated in double relative to the center and widened by its rounding error, so the
+     * interval is slightly wider than the exact range. Meant for pruning before exact checks.
+     *
+     * @return [y_min, y_max], or std::nullopt if the line does not intersect the ellipse
+     */
+    std::optional<std::pair<Float, Float>> YRange(const Float& x) const;
+    /**
+     * @brief Calculate an interval enclosing the range of x such that (x, y) is in the ellipse.
+     * @details Same as YRange with the roles of x and y swapped.
+     *
+     * @return [x_min, x_max], or std::nullopt if the line does not intersect the ellipse
+     */
+    std::optional<std::pair<Float, Float>> XRange(const Float& y) const;
 
     void Translate(const Vec& v) { c_ += v; }
     void Rescale(const Float& s) { s_ *= s; }
@@ -1,11 +1,40 @@
 #include "qrot/grid_solver.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <limits>
+#include <numbers>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "qrot/isa.h"
+#include "qrot/trace.h"
 
 namespace qrot {
+#pragma region LambdaPowers
+const Float& LambdaPowers::Approx(std::int32_t n) {
+    using constant::f::Lambda, constant::f::InvLambda;
+    auto& table = n >= 0 ? approx_pos_ : approx_neg_;
+    const auto& base = n >= 0 ? Lambda : InvLambda;
+    const auto idx = static_cast<std::size_t>(std::abs(n));
+    while (table.size() <= idx) { table.emplace_back(table.back() * base); }
+    return table[idx];
+}
+const Z2& LambdaPowers::Exact(std::int32_t n) {
+    using constant::z2::Lambda, constant::z2::InvLambda;
+    auto& table = n >= 0 ? exact_pos_ : exact_neg_;
+    const auto& base = n >= 0 ? Lambda : InvLambda;
+    const auto idx = static_cast<std::size_t>(std::abs(n));
+    while (table.size() <= idx) { table.emplace_back(table.back() * base); }
+    return table[idx];
+}
+#pragma endregion
 #pragma region OneDimGridSolver
 bool OneDimGridSolver::Problem::IsValidSolution(const Float& a, const Float& b) const {
     using constant::f::Sqrt;
@@ -24,11 +53,7 @@ void OneDimGridSolver::Problem::DoLambda() {
     y0 *= -InvLambda;
     y1 *= -InvLambda;
     mp::swap(y0, y1);
-    if (!history.empty() && history.back() == Conversion::DoInvLambda) {
-        history.pop_back();
-    } else {
-        history.emplace_back(Conversion::DoLambda);
-    }
+    exponent--;
 }
 void OneDimGridSolver::Problem::DoInvLambda() {
     using constant::f::Lambda, constant::f::InvLambda;
@@ -37,50 +62,190 @@ void OneDimGridSolver::Problem::DoInvLambda() {
     y0 *= -Lambda;
     y1 *= -Lambda;
     mp::swap(y0, y1);
-    if (!history.empty() && history.back() == Conversion::DoLambda) {
-        history.pop_back();
-    } else {
-        history.emplace_back(Conversion::DoInvLambda);
+    exponent++;
+}
+void OneDimGridSolver::Problem::DoInvLambda(std::int32_t n, LambdaPowers& powers) {
+    // x *= lambda^{-n}, y *= (-lambda)^n
+    {
+        const auto& s = powers.Approx(-n);
+        x0 *= s;
+        x1 *= s;
     }
+    {
+        const auto& s = powers.Approx(n);
+        y0 *= s;
+        y1 *= s;
+    }
+    if (n % 2 != 0) {
+        y0 = -y0;
+        y1 = -y1;
+        mp::swap(y0, y1);
+    }
+    exponent += n;
 }
+namespace {
+/**
+ * @brief Double-precision filter of the candidates b = min_b + j of the scaled 1-dim problem.
+ * @details With c = x1 - \sqrt{2} min_b split into c_int + c_frac and t_j = c_frac - \sqrt{2} j,
+ * the candidate a = floor(x1 - \sqrt{2} b) is c_int + floor(t_j) and x1 - (a + \sqrt{2} b) is
+ * f_j = t_j - floor(t_j). Hence
+ * * x0 <= a + \sqrt{2} b iff f_j <= x1 - x0,
+ * * y0 <= a - \sqrt{2} b <= y1 iff d1 <= f_j + 2 \sqrt{2} j <= d0,
+ * where d_i = x1 - 2 \sqrt{2} min_b - y_i.
+ * After the lambda-rescaling these quantities are small, so they are evaluated in double for a
+ * block of j at once. A lane within `margin` of a boundary is left to the exact check.
+ * Lanes are stored as doubles holding the value of Lane, so that every store of the loop is as
+ * wide as its arithmetic and the AVX2 and AVX-512 variants use full-width vectors.
+ */
+struct DoubleFilter {
+    enum class Lane : std::uint8_t { Reject, Accept, Exact };
+    static constexpr auto BlockSize = std::size_t{16};
+    /// Largest number of candidates for which j and the margin stay exact enough in double
+    static constexpr auto MaxCount = 0x1p40;
+
+    double c_frac, width, d0, d1, margin;
+};
+/// Classify j = first, ..., first + BlockSize - 1 and store floor(t_j) of accepted lanes
+QROT_ALWAYS_INLINE void ClassifyBody(const DoubleFilter& filter, std::int64_t first,
+                                     double* floors, double* lanes) {
+    using Lane = DoubleFilter::Lane;
+    constexpr auto Accept = static_cast<double>(Lane::Accept);
+    constexpr auto Exact = static_cast<double>(Lane::Exact);
+    constexpr auto Reject = static_cast<double>(Lane::Reject);
+    constexpr auto Sqrt = std::numbers::sqrt2;
+    constexpr auto Round = 0x1.8p52;
+    const auto& [c_frac, width, d0, d1, margin] = filter;
+    const auto base = static_cast<double>(first);
+    for (auto i = std::int32_t{0}; i < static_cast<std::int32_t>(DoubleFilter::BlockSize); ++i) {
+        const auto j = base + i;
+        const auto t = c_frac - Sqrt * j;
+        // floor(t) by rounding t - 1/2, as std::floor is not vectorized with -ftrapping-math. It is
+        // off by one only if t is an integer, where f is 0 or 1 and the lane is Exact anyway
+        const auto fl = ((t - 0.5) + Round) - Round;
+        const auto f = t - fl;
+        const auto u = f + 2 * Sqrt * j;
+        // Bitwise operators keep the loop free of branches; accept and reject are exclusive
+        const auto floor_exact = (margin < f) & (f < 1 - margin);
+        const auto reject = (width + margin < f) | (u < d1 - margin) | (d0 + margin < u);
+        const auto accept = (f < width - margin) & (d1 + margin < u) & (u < d0 - margin);
+        const auto exact = !floor_exact | !(reject | accept);
+        floors[i] = fl;
+        lanes[i] = exact ? Exact : (accept ? Accept : Reject);
+    }
+}
+using ClassifyFn = void(const DoubleFilter&, std::int64_t, double*, double*);
+void ClassifyScalar(const DoubleFilter& filter, std::int64_t first, double* floors, double* lanes) {
+    ClassifyBody(filter, first, floors, lanes);
+}
+#ifdef QROT_ISA_DISPATCH
+QROT_TARGET_AVX2 void ClassifyAVX2(const DoubleFilter& filter, std::int64_t first, double* floors,
+                                   double* lanes) {
+    ClassifyBody(filter, first, floors, lanes);
+}
+QROT_TARGET_AVX512 void ClassifyAVX512(const DoubleFilter& filter, std::int64_t first,
+                                       double* floors, double* lanes) {
+    ClassifyBody(filter, first, floors, lanes);
+}
+#endif
+const auto ClassifyKernel = IsaKernel<ClassifyFn>{
+#ifdef QROT_ISA_DISPATCH
+    &ClassifyScalar, &ClassifyAVX2, &ClassifyAVX512
+#else
+    &ClassifyScalar
+#endif
+};
+}  // namespace
 OneDimGridSolver::OneDimGridSolver(Float x0, Float x1, Float y0, Float y1)
-    : problem_{std::move(x0), std::move(x1), std::move(y0), std::move(y1), {}} {
+    : problem_{std::move(x0), std::move(x1), std::move(y0), std::move(y1)} {
 #ifdef QROT_VERBOSE
     if (problem_.x1 - problem_.x0 <= 0) { throw std::runtime_error("x1 must be larger than x0"); }
     if (problem_.y1 - problem_.y0 <= 0) { throw std::runtime_error("y1 must be larger than y0"); }
 #endif
 }
+OneDimGridSolver::OneDimGridSolver(Float x0, Float x1, Float y0, Float y1, LambdaPowers& powers)
+    : OneDimGridSolver(std::move(x0), std::move(x1), std::move(y0), std::move(y1)) {
+    powers_ = &powers;
+}
 void OneDimGridSolver::EnumerateAllSolutions() {
-    using namespace constant;
-    using f::Sqrt, f::InvSqrt3, f::InvLambda;
+    EnumerateSolutions(std::numeric_limits<std::size_t>::max());
+}
+void OneDimGridSolver::EnumerateSolutions(std::size_t max_count) {
+    using constant::f::InvLambda;
+    auto local_powers = LambdaPowers();
+    auto& powers = powers_ != nullptr ? *powers_ : local_powers;
+
+    // Scale the width into [lambda^{-1}, 1) at once, with the estimate corrected by single steps
+    static const auto LogLambda = std::log(1 + std::sqrt(2.0));
+    const auto log_width = std::log(static_cast<double>(problem_.x1 - problem_.x0)) / LogLambda;
+    if (std::isfinite(log_width)) {
+        problem_.DoInvLambda(static_cast<std::int32_t>(std::floor(log_width)) + 1, powers);
+    }
     while (problem_.x1 - problem_.x0 >= 1) { problem_.DoInvLambda(); }
     while (problem_.x1 - problem_.x0 < InvLambda) { problem_.DoLambda(); }
+    EnumerateScaledSolutions(max_count);
+
+    // Undo the scaling: the solutions of the scaled problem are lambda^{-exponent} times the
+    // solutions of the original problem
+    if (problem_.exponent != 0) {
+        const auto& s = powers.Exact(problem_.exponent);
+        for (auto&& solution : solutions_) { solution *= s; }
+    }
+}
+void OneDimGridSolver::EnumerateScaledSolutions(std::size_t max_count) {
+    using constant::f::Sqrt, constant::f::InvSqrt3;
     const Float min_b = mp::floor((problem_.x0 - problem_.y1) * InvSqrt3);
     const Float max_b = mp::ceil((problem_.x1 - problem_.y0) * InvSqrt3);
-    for (Float tmp_b = min_b; tmp_b <= max_b; tmp_b += Float{1}) {
+    // Exact check of b = min_b + j
+    const auto check = [this, &min_b](std::int64_t j) {
+        const Float tmp_b = min_b + j;
         const Float tmp_a = mp::floor(problem_.x1 - tmp_b * Sqrt);
-
-        // Check & Push
         if (problem_.IsValidSolution(tmp_a, tmp_b)) {
             solutions_.emplace_back(Z2(static_cast<Integer>(tmp_a), static_cast<Integer>(tmp_b)));
         }
+    };
+
+    const Float c = problem_.x1 - min_b * Sqrt;
+    const Float c_floor = mp::floor(c);
+    const Float base = c - Sqrt * min_b;
+    auto filter = DoubleFilter{static_cast<double>(c - c_floor),
+                               static_cast<double>(problem_.x1 - problem_.x0),
+                               static_cast<double>(base - problem_.y0),
+                               static_cast<double>(base - problem_.y1), 0};
+    // Rounding errors grow with j and with the magnitude of d_i
+    const auto count = static_cast<double>(max_b - min_b) + 1;
+    filter.margin = std::ldexp(count + std::abs(filter.d0) + std::abs(filter.d1) + 4, -44);
+    if (!(count <= DoubleFilter::MaxCount) || !std::isfinite(filter.margin)) {
+        for (auto j = std::int64_t{0}; j < count && solutions_.size() < max_count; ++j) {
+            check(j);
+        }
+        return;
     }
 
-    while (!problem_.history.empty()) {
-        const auto& event = problem_.history.back();
-        switch (event) {
-            case Problem::Conversion::DoLambda: {
-                problem_.DoInvLambda();
-                for (auto&& solution : solutions_) { solution *= z2::InvLambda; }
-                break;
-            }
-            case Problem::Conversion::DoInvLambda: {
-                problem_.DoLambda();
-                for (auto&& solution : solutions_) { solution *= z2::Lambda; }
-                break;
+    // Candidates decided by the filter are pushed as they are, and the others are checked exactly
+    const auto c_int = static_cast<Integer>(c_floor);
+    const auto b_int = static_cast<Integer>(min_b);
+    const auto n = static_cast<std::int64_t>(count);
+    constexpr auto BlockSize = static_cast<std::int64_t>(DoubleFilter::BlockSize);
+    auto floors = std::array<double, DoubleFilter::BlockSize>();
+    auto lanes = std::array<double, DoubleFilter::BlockSize>();
+    const auto classify = ClassifyKernel.Get();
+    for (auto first = std::int64_t{0}; first < n && solutions_.size() < max_count;
+         first += BlockSize) {
+        classify(filter, first, floors.data(), lanes.data());
+        const auto size = std::min(BlockSize, n - first);
+        for (auto i = std::int64_t{0}; i < size; ++i) {
+            switch (static_cast<DoubleFilter::Lane>(lanes[i])) {
+                case DoubleFilter::Lane::Reject: break;
+                case DoubleFilter::Lane::Accept:
+                    solutions_.emplace_back(Z2(c_int + static_cast<std::int64_t>(floors[i]),
+                                               b_int + (first + i)));
+                    break;
+                case DoubleFilter::Lane::Exact: check(first + i); break;
             }
         }
     }
+    // The last block may overshoot
+    if (solutions_.size() > max_count) { solutions_.resize(max_count); }
 }
 #pragma endregion
 #pragma region FindGridOperation
@@ -98,6 +263,7 @@ struct UnitGridOperation {
         Shift,
         R,
         K,
+        KAdj2,
         A,
         B,
         Z,
@@ -107,6 +273,7 @@ struct UnitGridOperation {
     static UnitGridOperation Shift(const Integer& n) { return {Type::Shift, n}; }
     static UnitGridOperation R() { return {Type::R}; }
     static UnitGridOperation K() { return {Type::K}; }
+    static UnitGridOperation KAdj2() { return {Type::KAdj2}; }
     static UnitGridOperation A(const Integer& n) { return {Type::A, n}; }
     static UnitGridOperation B(const Integer& n) { return {Type::B, n}; }
     static UnitGridOperation Z() { return {Type::Z}; }
@@ -124,6 +291,8 @@ MD2 UnitGridOperation::GridOperator() const {
         case UnitGridOperation::Type::R: return MD2(HalfSqrt, -HalfSqrt, HalfSqrt, HalfSqrt);
         case UnitGridOperation::Type::K:
             return MD2(HalfSqrt - D2{1}, -HalfSqrt, HalfSqrt + D2{1}, HalfSqrt);
+        case UnitGridOperation::Type::KAdj2:
+            return MD2(-HalfSqrt - D2{1}, HalfSqrt, -HalfSqrt + D2{1}, -HalfSqrt);
         case UnitGridOperation::Type::A: return MD2(1, D2(-2 * n), 0, 1);
         case UnitGridOperation::Type::B: return MD2(1, D2(0, n), 0, 1);
         case UnitGridOperation::Type::Z: return MD2(1, 0, 0, -1);
@@ -135,6 +304,7 @@ MD2 UnitGridOperation::GridOperator() const {
 //         case UnitGridOperation::Type::Shift: return out << "Shift(" << op.n << ')';
 //         case UnitGridOperation::Type::R: return out << 'R';
 //         case UnitGridOperation::Type::K: return out << 'K';
+//         case UnitGridOperation::Type::KAdj2: return out << "K*";
 //         case UnitGridOperation::Type::A: return out << "A(" << op.n << ')';
 //         case UnitGridOperation::Type::B: return out << "B(" << op.n << ')';
 //         case UnitGridOperation::Type::Z: return out << 'Z';
@@ -159,6 +329,7 @@ private:
     void Step();
     void R();
     void K();
+    void KAdj2();
     void A();
     void B();
 
@@ -218,7 +389,7 @@ void FindGridOperator::Step() {
         } else if (p03 <= state.z1 && p03 <= state.z2) {
             A();
         } else if (p08 <= state.z1 && state.z2 <= p03) {
-            K();
+            KAdj2();
         } else {
             assert(0 && "Unreachable");
         }
@@ -268,6 +439,25 @@ void FindGridOperator::K() {
     }
     history.back().emplace_back(UnitGridOperation::K());
 }
+void FindGridOperator::KAdj2() {
+    // K with \sqrt{2} -> -\sqrt{2}, i.e. the actions of K on the two ellipses are swapped
+    using constant::f::Sqrt;
+    {
+        const Float b = Sqrt * state.b1 - state.e1 * CoshL(state.z1 - 1);
+        const Float x = state.e1 * CoshL(state.z1 - 2) - state.b1;
+        const Float y = state.e1 * CoshL(state.z1) - state.b1;
+        std::tie(state.e1, state.z1) = ToExponentFormat(x, y);
+        state.b1 = b;
+    }
+    {
+        const Float b = state.e2 * CoshL(state.z2 + 1) - Sqrt * state.b2;
+        const Float x = state.e2 * CoshL(state.z2 + 2) - state.b2;
+        const Float y = state.e2 * CoshL(state.z2) - state.b2;
+        std::tie(state.e2, state.z2) = ToExponentFormat(x, y);
+        state.b2 = b;
+    }
+    history.back().emplace_back(UnitGridOperation::KAdj2());
+}
 void FindGridOperator::A() {
     using constant::f::Lambda;
     Integer n = mp::max(
@@ -339,6 +529,116 @@ void FindGridOperator::X() {
 }
 }  // namespace
 #pragma endregion FindGridOperation
+#pragma region ReduceGridOperator
+namespace {
+/**
+ * @brief Search a grid operator by the lattice reduction of Z[\sqrt{2}]^2.
+ * @details Gauss' algorithm over Z[\sqrt{2}] reduces the basis (b1, b2) of Z[\sqrt{2}]^2 with
+ * respect to N(v) = Q1(v) Q2(v^\bullet) for Q1(v) = v^T D1 v and Q2(v) = v^T D2 v, where D1 and D2
+ * are the normalized matrices of the ellipse pair. N is invariant under the units of Z[\sqrt{2}].
+ * * b1 and b2 are multiplied by lambda^k and lambda^{-k} to balance Q1(b1) and Q2(b1^\bullet),
+ * * b2 is size-reduced by b2 -= mu b1 with mu in \sqrt{2} Z[\sqrt{2}],
+ * * b1 and b2 are exchanged while N(b2) < N(b1).
+ * Every step has determinant 1 and is congruent to I or X modulo \sqrt{2}, so [b1 b2] maps Z[omega]
+ * onto itself. Each exchange shrinks the skew like a step of Euclid's algorithm, whereas a R/K/A/B
+ * step of FindGridOperator only reduces it by a constant factor.
+ */
+struct ReduceGridOperator {
+    Mat d1, d2;
+    Z2 x1 = Z2{1}, y1 = Z2{0};  // b1
+    Z2 x2 = Z2{0}, y2 = Z2{1};  // b2
+
+    void Reduce();
+    MD2 GridOperator() const { return MD2(ToD2(x1), ToD2(x2), ToD2(y1), ToD2(y2)); }
+
+private:
+    /// Entries p = Q_i(b1), q = B_i(b1, b2), s = Q_i(b2) of the Gram matrices of both terms
+    struct Gram {
+        Float p1, q1, s1;
+        Float p2, q2, s2;
+    };
+    Gram CalcGram() const;
+    void Balance(const Gram& gram);
+    void SizeReduce(const Gram& gram);
+};
+ReduceGridOperator::Gram ReduceGridOperator::CalcGram() const {
+    const auto form = [](const Mat& d, const Vec& u, const Vec& v) -> Float {
+        return u.X() * (d.Get(0, 0) * v.X() + d.Get(0, 1) * v.Y()) +
+               u.Y() * (d.Get(1, 0) * v.X() + d.Get(1, 1) * v.Y());
+    };
+    const auto u1 = Vec(x1.ToFloat(), y1.ToFloat());
+    const auto v1 = Vec(x2.ToFloat(), y2.ToFloat());
+    const auto u2 = Vec(x1.Adj2().ToFloat(), y1.Adj2().ToFloat());
+    const auto v2 = Vec(x2.Adj2().ToFloat(), y2.Adj2().ToFloat());
+    return {form(d1, u1, u1), form(d1, u1, v1), form(d1, v1, v1),
+            form(d2, u2, u2), form(d2, u2, v2), form(d2, v2, v2)};
+}
+void ReduceGridOperator::Balance(const Gram& gram) {
+    // Q1(lambda^k b1) = lambda^{2k} p1 and Q2((lambda^k b1)^\bullet) = lambda^{-2k} p2, so k is
+    // the rounded log_lambda(p2 / p1) / 4, which needs only a few bits of p2 / p1
+    static const auto InvLog2Lambda = 1 / std::log2(1 + std::sqrt(2.0));
+    auto exp = 0;
+    const auto mantissa = static_cast<double>(mp::frexp(Float{gram.p2 / gram.p1}, &exp));
+    const auto k = static_cast<std::int32_t>(
+        std::lround((exp + std::log2(mantissa)) * InvLog2Lambda / 4));
+    if (k == 0) { return; }
+    auto powers = LambdaPowers();
+    const auto s = powers.Exact(k);
+    const auto& inv_s = powers.Exact(-k);
+    x1 *= s;
+    y1 *= s;
+    x2 *= inv_s;
+    y2 *= inv_s;
+}
+void ReduceGridOperator::SizeReduce(const Gram& gram) {
+    using constant::f::Sqrt;
+    // With det [b1 b2] = 1, N(b2 - mu b1) = (p1 t1^2 + 1 / p1) (p2 t2^2 + 1 / p2) for t1 = mu - r1
+    // and t2 = mu^\bullet - r2. mu = 2n + \sqrt{2} m is searched around the minimizer of
+    // t1^2 + t2^2.
+    const Float r1 = gram.q1 / gram.p1;
+    const Float r2 = gram.q2 / gram.p2;
+    const Float inv_p1 = 1 / gram.p1;
+    const Float inv_p2 = 1 / gram.p2;
+    const auto n0 = static_cast<Integer>(mp::round((r1 + r2) / 4));
+    const auto m0 = static_cast<Integer>(mp::round((r1 - r2) / (2 * Sqrt)));
+    auto best_n = n0;
+    auto best_m = m0;
+    auto best = Float{-1};
+    for (auto dn = -1; dn <= 1; ++dn) {
+        for (auto dm = -1; dm <= 1; ++dm) {
+            const auto n = n0 + dn;
+            const auto m = m0 + dm;
+            const Float t1 = 2 * Float{n} + Sqrt * Float{m} - r1;
+            const Float t2 = 2 * Float{n} - Sqrt * Float{m} - r2;
+            const Float value = (gram.p1 * t1 * t1 + inv_p1) * (gram.p2 * t2 * t2 + inv_p2);
+            if (best < 0 || value < best) {
+                best = value;
+                best_n = n;
+                best_m = m;
+            }
+        }
+    }
+    if (best_n == 0 && best_m == 0) { return; }
+    const auto mu = Z2(2 * best_n, best_m);
+    x2 -= mu * x1;
+    y2 -= mu * y1;
+}
+void ReduceGridOperator::Reduce() {
+    static const auto Delta = Float{"0.99"};
+    while (true) {
+        Balance(CalcGram());
+        SizeReduce(CalcGram());
+        const auto gram = CalcGram();
+        if (gram.s1 * gram.s2 >= Delta * gram.p1 * gram.p2) { break; }
+        // (b1, b2) <- (b2, -b1)
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+        x2 = -x2;
+        y2 = -y2;
+    }
+}
+}  // namespace
+#pragma endregion ReduceGridOperator
 #pragma region TwoDimGridSolver
 namespace {
 void Mul(const MD2& m, CD2& p) {
@@ -357,8 +657,47 @@ void DivSqrt(CD2& p, std::uint32_t e) {
         p.ImagMut().DivSqrt();
     }
 }
+/**
+ * @brief Inverse of the grid operator (mapped -> orig) making the ellipse pair upright.
+ */
+MD2 SearchGridOperator(const Ellipse& el1, const Ellipse& el2, GridOperatorSearch search) {
+    auto inv_g = MD2::Identity();
+    auto d1 = el1.Mat();
+    auto d2 = el2.Mat();
+    if (search == GridOperatorSearch::Lattice) {
+        QROT_TRACE_SCOPE("ReduceGridOperator");
+        auto reducer = ReduceGridOperator{d1, d2};
+        reducer.Reduce();
+        inv_g = reducer.GridOperator();
+        const auto x1 = ToMat(inv_g);
+        const auto x2 = ToMat(Adj2(inv_g));
+        d1 = x1.Transpose() * d1 * x1;
+        d2 = x2.Transpose() * d2 * x2;
+    }
+
+    // The R/K/A/B steps guarantee Skew() <= 15
+    auto finder = FindGridOperator();
+    std::tie(finder.state.e1, finder.state.z1) = ToExponentFormat(d1.Get(0, 0), d1.Get(1, 1));
+    finder.state.b1 = d1.Get(0, 1);
+    std::tie(finder.state.e2, finder.state.z2) = ToExponentFormat(d2.Get(0, 0), d2.Get(1, 1));
+    finder.state.b2 = d2.Get(0, 1);
+    finder.Find();
+    return inv_g * finder.GridOperator();
+}
 }  // namespace
-TwoDimGridSolver TwoDimGridSolver::New(const Float& theta, const Float& epsilon) {
+GridOperatorSearch DefaultGridOperatorSearch() {
+    static const auto search = [] {
+        const auto* env = std::getenv("QROT_GRID_OPERATOR");
+        const auto value = std::string_view(env != nullptr ? env : "");
+        if (value == "step") { return GridOperatorSearch::Step; }
+        return GridOperatorSearch::Lattice;
+    }();
+    return search;
+}
+TwoDimGridSolver TwoDimGridSolver::New(const Float& theta, const Float& epsilon,
+                                       GridOperatorSearch search) {
+    QROT_TRACE_SCOPE("TwoDimGridSolver::New");
+
     // Calculate the edge coordinates of the rectangle
     const auto cos = mp::cos(theta);
     const auto sin = mp::sin(theta);
@@ -374,15 +713,7 @@ TwoDimGridSolver TwoDimGridSolver::New(const Float& theta, const Float& epsilon)
     const auto orig_el2 = Ellipse::FromCircle(Vec(0, 0), 1);
 
     // Find grid operator
-    auto finder = FindGridOperator();
-    std::tie(finder.state.e1, finder.state.z1) = orig_el1.ExponentFormat();
-    finder.state.b1 = orig_el1.B();
-    std::tie(finder.state.e2, finder.state.z2) = orig_el2.ExponentFormat();
-    finder.state.b2 = orig_el2.B();
-    finder.Find();
-
-    // Apply grid operator
-    const auto inv_g1 = finder.GridOperator();
+    const auto inv_g1 = SearchGridOperator(orig_el1, orig_el2, search);
     const auto inv_g2 = Adj2(inv_g1);
     const auto g1 = inv_g1.Inv();
     const auto g2 = inv_g2.Inv();
@@ -410,11 +741,16 @@ void TwoDimGridSolver::EnumerateAllSolutions() {
     using constant::f::Lambda, constant::f::InvLog2;
     static const Float Thresh = Lambda * Lambda;
 
-    // Estimate good level
+    // Estimate good level. The estimate depends on the shapes of the mapped ellipses, so the search
+    // starts below it so as not to skip the lowest level with solutions, whose points would
+    // otherwise be mixed with those of the next level
+    static constexpr auto LevelMargin = 2;
     const auto& p = problem_;
     const auto width =
         std::max(p.bbox1.XWidth() * p.bbox2.XWidth(), p.bbox1.YWidth() * p.bbox2.YWidth());
-    level_ = static_cast<std::uint32_t>(mp::floor(mp::log(Thresh / width) * InvLog2));
+    const Float estimate = mp::floor(mp::log(Thresh / width) * InvLog2) - LevelMargin;
+    level_ = estimate > 0 ? static_cast<std::uint32_t>(estimate) : 0;
+    previous_level_solved_ = false;
 
     // Solve
     while (solutions_.empty()) {
@@ -428,84 +764,200 @@ void TwoDimGridSolver::EnumerateNextLevelAllSolutions() {
     solutions_.clear();
     Solve();
 }
+const Float& TwoDimGridSolver::LevelScale() {
+    using constant::f::Sqrt;
+    if (scale_level_ + 1 == level_) {
+        scale_ *= Sqrt;
+    } else if (scale_level_ != level_) {
+        scale_ = mp::pow(Sqrt, level_);
+    }
+    scale_level_ = level_;
+    return scale_;
+}
 void TwoDimGridSolver::Solve() {
-    using constant::f::Sqrt, constant::f::InvSqrt, constant::cd2::Omega;
+    QROT_TRACE_SCOPE("TwoDimGridSolver::Solve");
+    using constant::f::InvSqrt, constant::cd2::Omega;
 
     // Solve upright 2-dim grid problem
     const auto& cos = problem_.cos;
     const auto& sin = problem_.sin;
+    // p1 approximates within epsilon iff its projection onto (cos, sin) is at least
+    // 1 - epsilon^2 / 2 (the circular segment). el1 only covers the segment, so this is checked
+    // exactly below.
+    const Float min_proj = 1 - problem_.epsilon * problem_.epsilon / 2;
+    // Grid operators preserve Z[omega], so p1 is on level_ - 1 iff x + y i (+ omega) is divisible
+    // by \sqrt{2} in Z[omega]. Writing x + y i in the omega basis, this holds iff the integer parts
+    // of x and y have the same parity, and never holds with the translation by omega.
+    const auto skip_previous = previous_level_solved_;
+    // Whether no solution was left out by MaxSolutionsPerLevel, so the next level may skip this one
+    auto complete = true;
 
-    // Case1: a + b i
-    {
-        auto bbox1 = problem_.bbox1;
-        auto bbox2 = problem_.bbox2;
-        bbox1.Rescale(mp::pow(Sqrt, level_));
-        bbox2.Rescale(mp::pow(-Sqrt, level_));
-        auto x_solver = OneDimGridSolver(bbox1.x_min, bbox1.x_max, bbox2.x_min, bbox2.x_max);
-        auto y_solver = OneDimGridSolver(bbox1.y_min, bbox1.y_max, bbox2.y_min, bbox2.y_max);
+    // Bounding boxes and ellipses scaled by \sqrt{2}^level_ and (-\sqrt{2})^level_
+    const auto& scale = LevelScale();
+    const auto signed_scale = level_ % 2 == 0 ? scale : Float(-scale);
+    auto scaled_bbox1 = problem_.bbox1;
+    auto scaled_bbox2 = problem_.bbox2;
+    scaled_bbox1.Rescale(scale);
+    scaled_bbox2.Rescale(signed_scale);
+    const auto scaled_ellipse = [](const Ellipse& el, const Float& s, const Vec& offset) {
+        return Ellipse(el.Center() * s + offset, el.Scale() * mp::abs(s), el.A(), el.B(), el.D());
+    };
+
+    // Enumerate pairs (x, y) of the upright problem in the order of the cross product of the
+    // bounding boxes' solutions, restricted to y within the slices of the ellipses at x and
+    // x^\bullet. Only pairs within the slices reach the exact checks below.
+    // Near multiples of pi/4 the ellipses are nearly axis-aligned, and the solutions of one
+    // coordinate can outnumber those of the other by orders of magnitude. Then only the sparse
+    // coordinate is enumerated over the bounding boxes, and the dense one within the slices.
+    // Enumeration stops once MaxSolutionsPerLevel solutions are found.
+    static const auto MaxWidthRatio = Float{256};
+    const auto for_each_pair = [this, &complete](const BBox& bbox1, const BBox& bbox2,
+                                                 const Ellipse& el1, const Ellipse& el2,
+                                                 const auto& f) {
+        const auto stop = [&] {
+            if (solutions_.size() < MaxSolutionsPerLevel) { return false; }
+            complete = false;
+            return true;
+        };
+        const Float x_width = bbox1.XWidth() * bbox2.XWidth();
+        const Float y_width = bbox1.YWidth() * bbox2.YWidth();
+        if (x_width > MaxWidthRatio * y_width) {
+            auto y_solver =
+                OneDimGridSolver(bbox1.y_min, bbox1.y_max, bbox2.y_min, bbox2.y_max, powers_);
+            y_solver.EnumerateAllSolutions();
+            for (const auto& y : y_solver.GetSolutions()) {
+                if (stop()) { return; }
+                const auto range1 = el1.XRange(y.ToFloat());
+                if (!range1) { continue; }
+                const auto range2 = el2.XRange(y.Adj2().ToFloat());
+                if (!range2) { continue; }
+                auto x_solver = OneDimGridSolver(range1->first, range1->second, range2->first,
+                                                 range2->second, powers_);
+                x_solver.EnumerateSolutions(MaxSolutionsPerLevel);
+                const auto& xs = x_solver.GetSolutions();
+                complete &= xs.size() < MaxSolutionsPerLevel;
+                for (const auto& x : xs) { f(x, y); }
+            }
+            return;
+        }
+        if (y_width > MaxWidthRatio * x_width) {
+            auto x_solver =
+                OneDimGridSolver(bbox1.x_min, bbox1.x_max, bbox2.x_min, bbox2.x_max, powers_);
+            x_solver.EnumerateAllSolutions();
+            for (const auto& x : x_solver.GetSolutions()) {
+                if (stop()) { return; }
+                const auto range1 = el1.YRange(x.ToFloat());
+                if (!range1) { continue; }
+                const auto range2 = el2.YRange(x.Adj2().ToFloat());
+                if (!range2) { continue; }
+                auto y_solver = OneDimGridSolver(range1->first, range1->second, range2->first,
+                                                 range2->second, powers_);
+                y_solver.EnumerateSolutions(MaxSolutionsPerLevel);
+                const auto& ys = y_solver.GetSolutions();
+                complete &= ys.size() < MaxSolutionsPerLevel;
+                for (const auto& y : ys) { f(x, y); }
+            }
+            return;
+        }
+
+        auto x_solver =
+            OneDimGridSolver(bbox1.x_min, bbox1.x_max, bbox2.x_min, bbox2.x_max, powers_);
         x_solver.EnumerateAllSolutions();
+        auto y_solver =
+            OneDimGridSolver(bbox1.y_min, bbox1.y_max, bbox2.y_min, bbox2.y_max, powers_);
         y_solver.EnumerateAllSolutions();
+        const auto& ys = y_solver.GetSolutions();
+        // y in Float sorted, so that the y in the slice of el1 at each x are found by binary search
+        // and the cost per x is proportional to the slice instead of |ys|. y^\bullet in Float is
+        // compared against the slice of el2
+        auto sorted = std::vector<std::pair<Float, std::size_t>>();
+        auto y2_values = std::vector<Float>();
+        sorted.reserve(ys.size());
+        y2_values.reserve(ys.size());
+        for (auto i = std::size_t{0}; i < ys.size(); ++i) {
+            sorted.emplace_back(ys[i].ToFloat(), i);
+            y2_values.emplace_back(ys[i].Adj2().ToFloat());
+        }
+        std::sort(sorted.begin(), sorted.end());
+        auto hits = std::vector<std::size_t>();
         for (const auto& x : x_solver.GetSolutions()) {
-            for (const auto& y : y_solver.GetSolutions()) {
-                auto p1 = CD2(ToD2(x), ToD2(y));
-                auto p2 = CD2(ToD2(x.Adj2()), ToD2(y.Adj2()));
-                // Rescale
-                DivSqrt(p1, level_);
-                DivSqrt(p2, level_);
-                if (level_ % 2 != 0) { p2 = -p2; }
-                // mapped -> original
-                Mul(problem_.inv_g1_, p1);
-                Mul(problem_.inv_g2_, p2);
-                // Push valid solution
-                auto is_valid = true;
-                is_valid &= (p1.Norm() <= D2(1));
-                is_valid &= (p1.Real().ToFloat() * cos + p1.Imag().ToFloat() * sin <= 1);
-                is_valid &= (p2.Norm() <= D2(1));
-                if (is_valid) { solutions_.emplace_back(p1); }
+            if (stop()) { return; }
+            const auto range1 = el1.YRange(x.ToFloat());
+            if (!range1) { continue; }
+            const auto range2 = el2.YRange(x.Adj2().ToFloat());
+            if (!range2) { continue; }
+            const auto first = std::lower_bound(
+                sorted.begin(), sorted.end(), range1->first,
+                [](const auto& entry, const Float& value) { return entry.first < value; });
+            const auto last = std::upper_bound(
+                first, sorted.end(), range1->second,
+                [](const Float& value, const auto& entry) { return value < entry.first; });
+            hits.clear();
+            for (auto it = first; it != last; ++it) {
+                const auto& y2 = y2_values[it->second];
+                if (y2 < range2->first || range2->second < y2) { continue; }
+                hits.emplace_back(it->second);
             }
+            // Keep the order of ys
+            std::sort(hits.begin(), hits.end());
+            for (const auto i : hits) { f(x, ys[i]); }
         }
+    };
+
+    // Case1: a + b i
+    {
+        const auto el1 = scaled_ellipse(problem_.el1, scale, Vec(0, 0));
+        const auto el2 = scaled_ellipse(problem_.el2, signed_scale, Vec(0, 0));
+        for_each_pair(scaled_bbox1, scaled_bbox2, el1, el2, [&](const Z2& x, const Z2& y) {
+            if (skip_previous && mp::bit_test(x.Int(), 0) == mp::bit_test(y.Int(), 0)) { return; }
+            auto p1 = CD2(ToD2(x), ToD2(y));
+            auto p2 = CD2(ToD2(x.Adj2()), ToD2(y.Adj2()));
+            // Rescale
+            DivSqrt(p1, level_);
+            DivSqrt(p2, level_);
+            if (level_ % 2 != 0) { p2 = -p2; }
+            // mapped -> original
+            Mul(problem_.inv_g1_, p1);
+            Mul(problem_.inv_g2_, p2);
+            // Push valid solution
+            auto is_valid = true;
+            is_valid &= (p1.Norm() <= D2(1));
+            is_valid &= (p1.Real().ToFloat() * cos + p1.Imag().ToFloat() * sin >= min_proj);
+            is_valid &= (p2.Norm() <= D2(1));
+            if (is_valid) { solutions_.emplace_back(p1); }
+        });
     }
 
     // a + b i + \omega
     {
-        auto bbox1 = problem_.bbox1;
-        auto bbox2 = problem_.bbox2;
-        bbox1.Rescale(mp::pow(Sqrt, level_));
-        bbox2.Rescale(mp::pow(-Sqrt, level_));
+        auto bbox1 = scaled_bbox1;
+        auto bbox2 = scaled_bbox2;
         bbox1.Translate(Vec(-InvSqrt, -InvSqrt));
         bbox2.Translate(Vec(InvSqrt, InvSqrt));
-        auto x_solver = OneDimGridSolver(bbox1.x_min, bbox1.x_max, bbox2.x_min, bbox2.x_max);
-        auto y_solver = OneDimGridSolver(bbox1.y_min, bbox1.y_max, bbox2.y_min, bbox2.y_max);
-        x_solver.EnumerateAllSolutions();
-        y_solver.EnumerateAllSolutions();
-        for (const auto& x : x_solver.GetSolutions()) {
-            for (const auto& y : y_solver.GetSolutions()) {
-                auto p1 = CD2(ToD2(x), ToD2(y));
-                auto p2 = CD2(ToD2(x.Adj2()), ToD2(y.Adj2()));
-                // Translate
-                p1 += Omega;
-                p2 -= Omega;
-                // Rescale
-                DivSqrt(p1, level_);
-                DivSqrt(p2, level_);
-                if (level_ % 2 != 0) { p2 = -p2; }
-                // mapped -> original
-                Mul(problem_.inv_g1_, p1);
-                Mul(problem_.inv_g2_, p2);
-                // Push valid solutions
-                auto is_valid = true;
-                is_valid &= (p1.Norm() <= D2(1));
-                is_valid &= (p1.Real().ToFloat() * cos + p1.Imag().ToFloat() * sin <= 1);
-                is_valid &= (p2.Norm() <= D2(1));
-                if (is_valid) { solutions_.emplace_back(p1); }
-            }
-        }
+        const auto el1 = scaled_ellipse(problem_.el1, scale, Vec(-InvSqrt, -InvSqrt));
+        const auto el2 = scaled_ellipse(problem_.el2, signed_scale, Vec(InvSqrt, InvSqrt));
+        for_each_pair(bbox1, bbox2, el1, el2, [&](const Z2& x, const Z2& y) {
+            auto p1 = CD2(ToD2(x), ToD2(y));
+            auto p2 = CD2(ToD2(x.Adj2()), ToD2(y.Adj2()));
+            // Translate
+            p1 += Omega;
+            p2 -= Omega;
+            // Rescale
+            DivSqrt(p1, level_);
+            DivSqrt(p2, level_);
+            if (level_ % 2 != 0) { p2 = -p2; }
+            // mapped -> original
+            Mul(problem_.inv_g1_, p1);
+            Mul(problem_.inv_g2_, p2);
+            // Push valid solutions
+            auto is_valid = true;
+            is_valid &= (p1.Norm() <= D2(1));
+            is_valid &= (p1.Real().ToFloat() * cos + p1.Imag().ToFloat() * sin >= min_proj);
+            is_valid &= (p2.Norm() <= D2(1));
+            if (is_valid) { solutions_.emplace_back(p1); }
+        });
     }
-
-#ifdef QROT_VERBOSE
-    std::cout << "Solve level = " << level_ << " and found " << solutions_.size() << " solutions"
-              << std::endl;
-#endif
+    previous_level_solved_ = complete;
 }
 #pragma endregion
 }  // namespace qrot
@@ -1,6 +1,7 @@
 #ifndef QROT_GRID_SOLVER_H
 #define QROT_GRID_SOLVER_H
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -8,6 +9,26 @@
 #include "qrot/number.h"
 
 namespace qrot {
+#pragma region LambdaPowers
+/**
+ * @brief Table of lambda^n (n in Z) for lambda = 1 + \sqrt{2}, grown on demand.
+ * @details A TwoDimGridSolver shares one table among the one-dimensional solvers of all levels.
+ * References are invalidated by the next call.
+ */
+class LambdaPowers {
+public:
+    /// lambda^n in Float
+    const Float& Approx(std::int32_t n);
+    /// lambda^n in Z2 (lambda is a unit of Z2)
+    const Z2& Exact(std::int32_t n);
+
+private:
+    std::vector<Float> approx_pos_ = {Float{1}};  //!< lambda^0, lambda^1, ...
+    std::vector<Float> approx_neg_ = {Float{1}};  //!< lambda^0, lambda^{-1}, ...
+    std::vector<Z2> exact_pos_ = {Z2{1}};
+    std::vector<Z2> exact_neg_ = {Z2{1}};
+};
+#pragma endregion
 #pragma region OneDimGridSolver
 /**
  * @brief Solve one-dimensional grid-problems defined in 1403.2975.
@@ -20,39 +41,76 @@ namespace qrot {
 class OneDimGridSolver {
 public:
     OneDimGridSolver(Float x0, Float x1, Float y0, Float y1);
+    OneDimGridSolver(Float x0, Float x1, Float y0, Float y1, LambdaPowers& powers);
 
     void EnumerateAllSolutions();
+    /**
+     * @brief Enumerate solutions until `max_count` of them are found.
+     */
+    void EnumerateSolutions(std::size_t max_count);
 
     const std::vector<Z2>& GetSolutions() { return solutions_; }
 
 private:
     struct Problem {
         Float x0, x1, y0, y1;
-        enum class Conversion { DoLambda, DoInvLambda };
-        std::vector<Conversion> history;
+        std::int32_t exponent = 0;  //!< Net number of DoInvLambda applied
 
         bool IsValidSolution(const Float& a, const Float& b) const;
         void DoLambda();
         void DoInvLambda();
+        /// DoInvLambda n times (DoLambda -n times if n < 0)
+        void DoInvLambda(std::int32_t n, LambdaPowers& powers);
     };
 
+    /// Enumerate the solutions of the lambda-rescaled problem
+    void EnumerateScaledSolutions(std::size_t max_count);
+
     Problem problem_;
+    LambdaPowers* powers_ = nullptr;
     std::vector<Z2> solutions_ = {};
 };
 #pragma endregion
 #pragma region TwoDimGridSolver
+/**
+ * @brief Algorithm searching the grid operator which makes the ellipse pair upright.
+ */
+enum class GridOperatorSearch {
+    Step,     //!< R/K/A/B steps of 1403.2975 until the skew is at most 15
+    Lattice,  //!< Lattice reduction of Z[\sqrt{2}]^2, finished by Step
+};
+/**
+ * @brief GridOperatorSearch selected by the environment variable QROT_GRID_OPERATOR.
+ * @details "step" or "lattice", read once. Lattice if unset or unknown: BM_TwoDimGridSolverNew
+ * measures 10-40 ms for Lattice and 0.35-6 s for Step over 10 to 100 digits, and Step is faster
+ * for no measured angle or epsilon. Step is kept for comparison.
+ */
+GridOperatorSearch DefaultGridOperatorSearch();
+
 /**
  * @brief Solve two-dimensional grid problems defined in 1403.2975.
  * @details Implementation of section 5 of 1403.2975.
  */
 class TwoDimGridSolver {
 public:
-    static TwoDimGridSolver New(const Float& theta, const Float& epsilon);
+    /// Number of solutions after which the enumeration of a level stops. Levels of angles close to
+    /// multiples of pi/4 can have billions of solutions, of which only the first few are tried
+    static constexpr auto MaxSolutionsPerLevel = std::size_t{1} << 12;
+
+    static TwoDimGridSolver New(const Float& theta, const Float& epsilon,
+                                GridOperatorSearch search = DefaultGridOperatorSearch());
 
     void EnumerateAllSolutions();
+    /**
+     * @brief Enumerate solutions of the next level that were not solutions of the current level.
+     * @details Solutions of level k are the points of Z[omega] / \sqrt{2}^k in a fixed region, so
+     * the points of level k + 1 divisible by \sqrt{2} were already enumerated at level k. They are
+     * enumerated again if level k stopped at MaxSolutionsPerLevel.
+     */
     void EnumerateNextLevelAllSolutions();
 
     const std::vector<CD2>& GetSolutions() { return solutions_; }
+    std::uint32_t Level() const { return level_; }
 
 private:
     struct Problem {
@@ -74,9 +132,15 @@ private:
 
     TwoDimGridSolver(Problem&& problem) : problem_{std::move(problem)} {}
     void Solve();
+    /// \sqrt{2}^level_, updated incrementally when the level is incremented
+    const Float& LevelScale();
 
     const Problem problem_;
-    std::uint32_t level_ = 0;  //!< Search level
+    std::uint32_t level_ = 0;             //!< Search level
+    bool previous_level_solved_ = false;  //!< Whether level_ - 1 has been enumerated in full
+    std::uint32_t scale_level_ = 0;       //!< Level of scale_
+    Float scale_ = 1;                     //!< \sqrt{2}^scale_level_
+    LambdaPowers powers_;
     std::vector<CD2> solutions_ = {};
 };
 #pragma endregion
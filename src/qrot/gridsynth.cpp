@@ -0,0 +1,212 @@
+#include "qrot/gridsynth.h"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "qrot/decomposition.h"
+#include "qrot/diophantine.h"
+#include "qrot/grid_solver.h"
+#include "qrot/matrix.h"
+#include "qrot/number.h"
+#include "qrot/trace.h"
+
+namespace qrot {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Elapsed milliseconds since `start`, which is reset to now.
+ */
+double Lap(Clock::time_point& start) {
+    const auto now = Clock::now();
+    const auto ms = std::chrono::duration<double, std::milli>(now - start).count();
+    start = now;
+    return ms;
+}
+std::size_t Bits(const Integer& n) {
+    return n == 0 ? 0 : static_cast<std::size_t>(mp::msb(mp::abs(n)) + 1);
+}
+std::size_t MaxBits(const CD2& x) {
+    return std::max({Bits(x.Real().Int().Num()), Bits(x.Real().Sqrt().Num()),
+                     Bits(x.Imag().Int().Num()), Bits(x.Imag().Sqrt().Num())});
+}
+
+/**
+ * @brief Solvers shared by all GridSynth calls.
+ * @details The sieve of Diophantine and the table of UnitaryDecomposer are built once, and the
+ * factorizations and split primes cached by Diophantine persist across calls. Both are safe to
+ * use from several threads.
+ */
+struct Context {
+    Diophantine diophantine;
+    UnitaryDecomposer decomposer;
+};
+Context& SharedContext() {
+    static auto context = Context();
+    return context;
+}
+
+/**
+ * @brief GridSynth looking up and storing canonical gates in `index` unless it is null.
+ */
+SynthesisResult Synthesize(const Float& theta, std::uint32_t digits, RotationIndex* index) {
+    QROT_TRACE_SCOPE("GridSynth");
+    auto stats = SynthesisStats();
+    const auto start = Clock::now();
+    auto lap = start;
+
+    const auto octant = OctantReduction::New(theta);
+    const auto epsilon = Float("1e-" + std::to_string(digits));
+    // u = 1 or e^{-i pi/8} (Rz(pi/4) = e^{-i pi/8} T) solves the grid problem if its projection
+    // onto e^{-i theta' / 2} is at least 1 - epsilon^2 / 2. The grid search is not needed there and
+    // degenerates, e.g. xi = 1 - |u|^2 = 0
+    const Float min_proj = 1 - epsilon * epsilon / 2;
+    const auto near_pi_over_4 = mp::cos((constant::f::Pi / 4 - octant.theta) / 2) >= min_proj;
+    if (near_pi_over_4 || mp::cos(octant.theta / 2) >= min_proj) {
+        auto gate = octant.Restore(*ExactRz(Rational(near_pi_over_4 ? 1 : 0, 4)));
+        stats.t_count = gate.CountT();
+        stats.total_ms = Lap(lap);
+        return {std::move(gate), stats};
+    }
+    if (index != nullptr) {
+        if (const auto cached = index->Find(octant.theta, epsilon)) {
+            auto gate = octant.Restore(*cached);
+            stats.t_count = gate.CountT();
+            stats.reused = true;
+            stats.total_ms = Lap(lap);
+            return {std::move(gate), stats};
+        }
+    }
+
+    stats.reduction_ms = Lap(lap);
+    const auto& [diophantine, decomposer] = SharedContext();
+    stats.setup_ms = Lap(lap);
+
+    auto grid_solver = TwoDimGridSolver::New(-octant.theta / Float{2}, epsilon);
+    stats.grid_operator_ms = Lap(lap);
+
+    grid_solver.EnumerateAllSolutions();
+    stats.enumeration_ms += Lap(lap);
+
+    auto diophantine_stats = Diophantine::Stats();
+    auto solution = std::optional<std::pair<CD2, CD2>>();
+    while (!solution) {
+        const auto& grid_solutions = grid_solver.GetSolutions();
+        stats.candidates_enumerated += grid_solutions.size();
+        auto xis = std::vector<D2>();
+        xis.reserve(grid_solutions.size());
+        for (const auto& u : grid_solutions) { xis.emplace_back(D2(1) - (u * u.Adj()).Real()); }
+        auto t = CD2();
+        const auto idx = diophantine.SolveFirst(xis, t, diophantine_stats);
+        if (idx < grid_solutions.size()) { solution.emplace(grid_solutions[idx], t); }
+        stats.diophantine_ms += Lap(lap);
+
+        if (!solution) {
+            grid_solver.EnumerateNextLevelAllSolutions();
+            stats.enumeration_ms += Lap(lap);
+        }
+    }
+    stats.level = grid_solver.Level();
+    stats.candidates_tried = diophantine_stats.tried;
+    stats.candidates_rejected = diophantine_stats.rejected;
+    stats.cache_hits = diophantine_stats.cache_hits;
+    stats.factorization_failures = diophantine_stats.factorization_failures;
+    stats.max_norm_bits = diophantine_stats.max_norm_bits;
+
+    const auto& [u, t] = *solution;
+    stats.max_coefficient_bits = std::max(MaxBits(u), MaxBits(t));
+    auto gate = decomposer.Decompose(MCD2(u, -t.Adj(), t, u.Adj()), false);
+    stats.decomposition_ms = Lap(lap);
+
+    if (index != nullptr) { index->Insert(octant.theta, epsilon, gate); }
+    gate = octant.Restore(gate);
+    stats.normalization_ms = Lap(lap);
+    stats.t_count = gate.CountT();
+    stats.total_ms = std::chrono::duration<double, std::milli>(lap - start).count();
+
+    return {std::move(gate), stats};
+}
+}  // namespace
+
+std::string SynthesisStats::ToJson() const {
+    auto ss = std::ostringstream();
+    ss << "{\"reduction_ms\":" << reduction_ms << ",\"setup_ms\":" << setup_ms
+       << ",\"grid_operator_ms\":" << grid_operator_ms
+       << ",\"enumeration_ms\":" << enumeration_ms << ",\"diophantine_ms\":" << diophantine_ms
+       << ",\"decomposition_ms\":" << decomposition_ms
+       << ",\"normalization_ms\":" << normalization_ms << ",\"total_ms\":" << total_ms
+       << ",\"level\":" << level << ",\"candidates_enumerated\":" << candidates_enumerated
+       << ",\"candidates_tried\":" << candidates_tried
+       << ",\"candidates_rejected\":" << candidates_rejected << ",\"cache_hits\":" << cache_hits
+       << ",\"factorization_failures\":" << factorization_failures
+       << ",\"max_norm_bits\":" << max_norm_bits
+       << ",\"max_coefficient_bits\":" << max_coefficient_bits << ",\"t_count\":" << t_count
+       << ",\"reused\":" << (reused ? "true" : "false") << "}";
+    return ss.str();
+}
+
+OctantReduction OctantReduction::New(const Float& theta) {
+    using constant::f::Pi;
+    const auto q = Float(mp::round(2 * theta / Pi));
+    auto ret = OctantReduction{theta - q * Pi / 2};
+    auto k = mp::fmod(q, Float{8}).convert_to<std::int32_t>();
+    ret.quarter_turns = static_cast<std::uint32_t>(k < 0 ? k + 8 : k);
+    if (ret.theta < 0) {
+        ret.theta = -ret.theta;
+        ret.reflected = true;
+    }
+    return ret;
+}
+Gate OctantReduction::Restore(const Gate& gate) const {
+    // Rz(k pi / 2) is exact and T-free
+    auto ret = *ExactRz(Rational(quarter_turns, 2));
+    if (reflected) {
+        ret *= Atom::X();
+        ret *= gate;
+        ret *= Atom::X();
+    } else {
+        ret *= gate;
+    }
+    ret.Normalize();
+    return ret;
+}
+
+SynthesisResult GridSynth(const AST& theta, std::uint32_t digits) {
+    const auto start = Clock::now();
+    if (const auto r = theta.PiMultiple()) {
+        if (auto gate = ExactRz(*r)) {
+            auto stats = SynthesisStats();
+            stats.t_count = gate->CountT();
+            stats.total_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            return {std::move(*gate), stats};
+        }
+    }
+    return GridSynth(theta.Value(), digits);
+}
+std::optional<Gate> ExactRz(const Rational& r) {
+    const auto k4 = Rational(4 * r);
+    if (mp::denominator(k4) != 1) { return std::nullopt; }
+    // Rz is 4 pi periodic
+    auto k = static_cast<Integer>(mp::numerator(k4) % 16);
+    if (k < 0) { k += 16; }
+    const auto m = k.convert_to<std::uint32_t>();
+
+    // W^{-floor(m / 2)} T^m
+    auto gate = Gate();
+    for (auto i = std::uint32_t{0}; i < (8 - m / 2) % 8; ++i) { gate *= Atom::W(); }
+    for (auto i = std::uint32_t{0}; i < m % 8; ++i) { gate *= Atom::T(); }
+    gate.Normalize();
+    return gate;
+}
+void ClearGridSynthCache() { SharedContext().diophantine.ClearCache(); }
+SynthesisResult GridSynth(const Float& theta, std::uint32_t digits) {
+    return Synthesize(theta, digits, nullptr);
+}
+SynthesisResult GridSynth(const Float& theta, std::uint32_t digits, RotationIndex& index) {
+    return Synthesize(theta, digits, &index);
+}
+}  // namespace qrot
@@ -0,0 +1,103 @@
+#ifndef QROT_GRIDSYNTH_H
+#define QROT_GRIDSYNTH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "qrot/boost.h"
+#include "qrot/gate.h"
+#include "qrot/parser.h"
+#include "qrot/rotation_index.h"
+
+namespace qrot {
+/**
+ * @brief Measurements of one GridSynth call.
+ * @details Wall times are in milliseconds. Enumeration and Diophantine stages alternate level by
+ * level, so their times are summed over all levels.
+ */
+struct SynthesisStats {
+    double reduction_ms = 0;      //!< Octant reduction, exact shortcut and RotationIndex lookup
+    double setup_ms = 0;          //!< Construction of Diophantine and UnitaryDecomposer (once)
+    double grid_operator_ms = 0;  //!< TwoDimGridSolver::New (search for the grid operator)
+    double enumeration_ms = 0;    //!< Enumeration of grid solutions
+    double diophantine_ms = 0;    //!< Diophantine equations
+    double decomposition_ms = 0;  //!< Exact synthesis of the unitary matrix
+    double normalization_ms = 0;  //!< Conversion of the gate into the normal form
+    double total_ms = 0;
+
+    std::uint32_t level = 0;                 //!< Grid level of the solution
+    std::size_t candidates_enumerated = 0;   //!< Grid solutions over all levels
+    std::size_t candidates_tried = 0;        //!< Candidates passed to the Diophantine solver
+    std::size_t candidates_rejected = 0;     //!< Tried candidates without solution
+    std::size_t cache_hits = 0;              //!< Norm factorizations taken from the cache
+    std::size_t factorization_failures = 0;  //!< Composite factors Pollard-Rho failed to split
+    std::size_t max_norm_bits = 0;           //!< Largest norm factorized by the Diophantine solver
+    std::size_t max_coefficient_bits = 0;    //!< Largest numerator in the synthesized unitary
+    std::size_t t_count = 0;
+    bool reused = false;  //!< Taken from a RotationIndex without the grid search
+
+    /**
+     * @brief Serialize into a single-line JSON object.
+     */
+    std::string ToJson() const;
+};
+struct SynthesisResult {
+    Gate gate;
+    SynthesisStats stats;
+};
+
+/**
+ * @brief Reduction of a z-rotation angle into the octant [0, pi/4].
+ * @details Rz(theta) = Rz(k pi / 2) X^r Rz(theta') X^r with 0 <= theta' <= pi/4 and r in {0, 1}.
+ * Both corrections are Clifford, so a gate approximating Rz(theta') is mapped to a gate
+ * approximating Rz(theta) with the same T-count and the same error.
+ */
+struct OctantReduction {
+    Float theta;                      //!< Canonical angle theta' in [0, pi/4]
+    std::uint32_t quarter_turns = 0;  //!< k mod 8 (Rz is 4 pi periodic)
+    bool reflected = false;           //!< Whether theta' = -(theta - k pi / 2)
+
+    static OctantReduction New(const Float& theta);
+    /**
+     * @brief Apply the Clifford correction to a gate approximating Rz(theta').
+     *
+     * @return normal form of the gate approximating Rz(theta)
+     */
+    Gate Restore(const Gate& gate) const;
+};
+
+/**
+ * @brief Approximate the z-rotation Rz(theta) with Clifford+T gates up to error 10^{-digits}.
+ * @details theta is reduced into [0, pi/4] by OctantReduction before the grid search. The solvers
+ * are constructed by the first call and shared by later calls, together with their caches.
+ */
+SynthesisResult GridSynth(const Float& theta, std::uint32_t digits);
+/**
+ * @brief Drop the factorizations and split primes cached by earlier GridSynth calls.
+ */
+void ClearGridSynthCache();
+/**
+ * @brief GridSynth reusing gates stored in `index`.
+ * @details If `index` holds a gate within 10^{-digits} of the canonical rotation, it is returned
+ * without the grid search. Otherwise the synthesized gate is inserted into `index`.
+ */
+SynthesisResult GridSynth(const Float& theta, std::uint32_t digits, RotationIndex& index);
+/**
+ * @brief GridSynth for a parsed angle.
+ * @details Rz(k pi / 4) is returned by ExactRz without the grid search.
+ */
+SynthesisResult GridSynth(const AST& theta, std::uint32_t digits);
+/**
+ * @brief Express Rz(r pi) exactly with Clifford+T gates if 4r is an integer.
+ * @details Rz(k pi / 4) = e^{-i k pi / 8} T^k. For even k the phase is a power of omega and the
+ * gate is exact. For odd k the gate is e^{i pi / 8} Rz(k pi / 4), since e^{i pi / 8} is not in the
+ * ring.
+ *
+ * @return normal form of the gate, or std::nullopt if 4r is not an integer
+ */
+std::optional<Gate> ExactRz(const Rational& r);
+}  // namespace qrot
+
+#endif  // QROT_GRIDSYNTH_H
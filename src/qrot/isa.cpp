@@ -0,0 +1,55 @@
+#include "qrot/isa.h"
+
+#include <atomic>
+#include <cstdlib>
+
+namespace qrot {
+namespace {
+std::atomic<Isa>& ActiveIsaStorage() {
+    static auto active = std::atomic<Isa>([] {
+        const auto* env = std::getenv("QROT_ISA");
+        const auto requested = ParseIsa(env != nullptr ? env : "");
+        const auto detected = DetectIsa();
+        return requested && *requested <= detected ? *requested : detected;
+    }());
+    return active;
+}
+}  // namespace
+
+std::string_view ToString(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::AVX2: return "avx2";
+        case Isa::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+std::optional<Isa> ParseIsa(std::string_view name) {
+    for (const auto isa : {Isa::Scalar, Isa::AVX2, Isa::AVX512}) {
+        if (name == ToString(isa)) { return isa; }
+    }
+    return std::nullopt;
+}
+Isa DetectIsa() {
+#ifdef QROT_ISA_DISPATCH
+    static const auto detected = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") &&
+            __builtin_cpu_supports("avx512vl")) {
+            return Isa::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) { return Isa::AVX2; }
+        return Isa::Scalar;
+    }();
+    return detected;
+#else
+    return Isa::Scalar;
+#endif
+}
+Isa ActiveIsa() { return ActiveIsaStorage().load(std::memory_order_relaxed); }
+Isa SetActiveIsa(Isa isa) {
+    const auto selected = isa <= DetectIsa() ? isa : DetectIsa();
+    ActiveIsaStorage().store(selected, std::memory_order_relaxed);
+    return selected;
+}
+}  // namespace qrot
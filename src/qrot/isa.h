@@ -0,0 +1,69 @@
+#ifndef QROT_ISA_H
+#define QROT_ISA_H
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// Vectorized kernels get AVX2 and AVX-512 variants only where GCC-style target attributes and
+// __builtin_cpu_supports are available
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define QROT_ISA_DISPATCH
+#define QROT_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define QROT_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma")))
+#define QROT_ALWAYS_INLINE [[gnu::always_inline]] inline
+#else
+#define QROT_ALWAYS_INLINE inline
+#endif
+
+namespace qrot {
+/**
+ * @brief Instruction sets of the vectorized kernels, ordered by width.
+ */
+enum class Isa : std::uint8_t {
+    Scalar,  //!< Baseline of the build (SSE2 on x86-64)
+    AVX2,    //!< AVX2 and FMA
+    AVX512,  //!< AVX-512 F, DQ and VL
+};
+
+std::string_view ToString(Isa isa);
+std::optional<Isa> ParseIsa(std::string_view name);
+
+/**
+ * @brief Widest Isa supported by the CPU and the OS, detected with CPUID.
+ */
+Isa DetectIsa();
+/**
+ * @brief Isa used by the vectorized kernels.
+ * @details Initialized once to DetectIsa(), or to QROT_ISA=scalar|avx2|avx512 if it names an
+ * Isa the CPU supports.
+ */
+Isa ActiveIsa();
+/**
+ * @brief Change ActiveIsa(), e.g. to compare kernels in tests and benchmarks.
+ *
+ * @return Isa actually selected, which is `isa` narrowed to DetectIsa()
+ */
+Isa SetActiveIsa(Isa isa);
+
+/**
+ * @brief One kernel compiled for each Isa.
+ * @details The variants are wrappers with QROT_TARGET_AVX2 and QROT_TARGET_AVX512 around one
+ * QROT_ALWAYS_INLINE body, so the compiler vectorizes the same code for each instruction set.
+ * Variants left null fall back to the next narrower one.
+ */
+template <typename F>
+struct IsaKernel {
+    F* scalar;
+    F* avx2 = nullptr;
+    F* avx512 = nullptr;
+
+    F* Get(Isa isa = ActiveIsa()) const {
+        if (isa == Isa::AVX512 && avx512 != nullptr) { return avx512; }
+        if (isa != Isa::Scalar && avx2 != nullptr) { return avx2; }
+        return scalar;
+    }
+};
+}  // namespace qrot
+
+#endif  // QROT_ISA_H
@@ -89,13 +89,13 @@ private:
             den_exp_ = 0;
             return *this;
         }
-        while (den_exp_ > 0) {
-            if ((num_ & 1) == 0) {
-                num_ >>= 1;
-                den_exp_--;
-            } else {
-                break;
-            }
+        // bit_test reads the magnitude of cpp_int and the two's complement of GMP integers, which
+        // have the same trailing zeros, and unlike num_ & 1 allocates no temporary
+        auto shift = std::int32_t{0};
+        while (shift < den_exp_ && !mp::bit_test(num_, static_cast<unsigned>(shift))) { shift++; }
+        if (shift > 0) {
+            num_ >>= shift;
+            den_exp_ -= shift;
         }
         return *this;
     }
@@ -1,6 +1,8 @@
 #include "parser.h"
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -155,6 +157,47 @@ Float Value(const Node* node) {
             }
     }
 }
+/**
+ * @brief Exact value a + b * pi with rational a and b.
+ */
+struct PiAffine {
+    Rational a;
+    Rational b;
+};
+Rational ToRational(std::string_view digits) {
+    const auto dot = std::min(digits.find('.'), digits.size());
+    const auto frac = dot < digits.size() ? digits.substr(dot + 1) : std::string_view();
+    auto num = std::string(digits.substr(0, dot)) + std::string(frac);
+    // Leading zeros would be read as an octal prefix
+    num.erase(0, std::min(num.find_first_not_of('0'), num.size() - 1));
+    if (num.empty()) { num = "0"; }
+    return Rational(num + "/1" + std::string(frac.size(), '0'));
+}
+std::optional<PiAffine> PiAffineValue(const Node* node) {
+    if (node->kind == NodeKind::NUM) {
+        if (node->token->str == "pi") { return PiAffine{0, 1}; }
+        return PiAffine{ToRational(node->token->str), 0};
+    }
+    const auto l = PiAffineValue(node->l);
+    if (!l) { return std::nullopt; }
+    if (node->kind == NodeKind::SUB && node->r == nullptr) { return PiAffine{-l->a, -l->b}; }
+    const auto r = PiAffineValue(node->r);
+    if (!r) { return std::nullopt; }
+    switch (node->kind) {
+        case NodeKind::ADD: return PiAffine{l->a + r->a, l->b + r->b};
+        case NodeKind::SUB: return PiAffine{l->a - r->a, l->b - r->b};
+        case NodeKind::MUL:
+            // Products of pi are not affine
+            if (l->b == 0) { return PiAffine{l->a * r->a, l->a * r->b}; }
+            if (r->b == 0) { return PiAffine{l->a * r->a, l->b * r->a}; }
+            return std::nullopt;
+        case NodeKind::DIV:
+            if (r->b != 0 || r->a == 0) { return std::nullopt; }
+            return PiAffine{l->a / r->a, l->b / r->a};
+        case NodeKind::NUM: break;
+    }
+    return std::nullopt;
+}
 }  // namespace
 AST AST::Parse(const std::string& s) {
     auto ast = AST();
@@ -173,4 +216,9 @@ AST AST::Parse(const std::string& s) {
     return ast;
 }
 Float AST::Value() const { return ::qrot::Value(root_); }
+std::optional<Rational> AST::PiMultiple() const {
+    const auto value = PiAffineValue(root_);
+    if (!value || value->a != 0) { return std::nullopt; }
+    return value->b;
+}
 }  // namespace qrot
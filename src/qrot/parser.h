@@ -2,6 +2,7 @@
 #define QROT_PARSER_H
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -43,6 +44,13 @@ public:
 
     const Node* Root() const { return root_; }
     Float Value() const;
+    /**
+     * @brief Evaluate the expression exactly as a rational multiple of pi.
+     *
+     * @return r such that the value is r * pi, or std::nullopt if the value is not of this form
+     * (e.g. "0.1", "pi + 1", "pi * pi")
+     */
+    std::optional<Rational> PiMultiple() const;
 
 private:
     const Node* root_;
@@ -0,0 +1,65 @@
+#include "qrot/rotation_index.h"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "qrot/number.h"
+#include "qrot/trace.h"
+#include "qrot/verification.h"
+
+namespace qrot {
+std::optional<Gate> RotationIndex::Find(const Float& theta, const Float& epsilon) const {
+    QROT_TRACE_SCOPE("RotationIndex::Find");
+    const auto lock = std::lock_guard(mtx_);
+    if (entries_.empty()) { return std::nullopt; }
+
+    // Up to global phase, ||Rz(a) - Rz(b)|| = 2 |sin((a - b) / 4)| >= |a - b| / pi for
+    // |a - b| <= pi, so an entry within epsilon satisfies |a - b| <= pi (epsilon + max_epsilon_) by
+    // the triangle inequality, unless its angle differs by about a multiple of 2 pi
+    const auto key = static_cast<double>(theta);
+    const auto window = 4 * static_cast<double>(epsilon + max_epsilon_) +
+                        4 * std::numeric_limits<double>::epsilon() * (1 + std::abs(key));
+    const auto first = entries_.lower_bound(key - window);
+    const auto last = entries_.upper_bound(key + window);
+    if (first == last) { return std::nullopt; }
+
+    const Float half = theta / 2;
+    const Float c = mp::cos(half);
+    const Float s = mp::sin(half);
+    const Float bound = epsilon * epsilon;
+    auto best = std::optional<Gate>();
+    auto best_distance = Float{0};
+    for (auto itr = first; itr != last; ++itr) {
+        const auto& entry = itr->second;
+        const auto distance = SquaredRzDistance(entry.u00, entry.u11, c, s);
+        if (distance <= bound && (!best || distance < best_distance)) {
+            best = entry.gate;
+            best_distance = distance;
+        }
+    }
+    return best;
+}
+void RotationIndex::Insert(const Float& theta, const Float& epsilon, Gate gate) {
+    if (capacity_ == 0) { return; }
+    const auto u = ExactUnitary::FromGate(gate).ToMatC();
+    const auto lock = std::lock_guard(mtx_);
+    if (entries_.size() == capacity_) {
+        entries_.erase(order_.front());
+        order_.pop_front();
+    }
+    const auto key = static_cast<double>(theta);
+    order_.emplace_back(entries_.emplace(key, Entry{u.Get(0, 0), u.Get(1, 1), std::move(gate)}));
+    if (max_epsilon_ < epsilon) { max_epsilon_ = epsilon; }
+}
+void RotationIndex::Clear() {
+    const auto lock = std::lock_guard(mtx_);
+    entries_.clear();
+    order_.clear();
+    max_epsilon_ = 0;
+}
+std::size_t RotationIndex::Size() const {
+    const auto lock = std::lock_guard(mtx_);
+    return entries_.size();
+}
+}  // namespace qrot
@@ -0,0 +1,59 @@
+#ifndef QROT_ROTATION_INDEX_H
+#define QROT_ROTATION_INDEX_H
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+
+#include "qrot/boost.h"
+#include "qrot/gate.h"
+
+namespace qrot {
+/**
+ * @brief Nearest-neighbour index over synthesized z-rotations.
+ * @details A lookup for Rz(theta) returns a stored gate only if its exact unitary is certified to
+ * be within epsilon of Rz(theta) up to global phase (see SquaredRzDistance), so angles that agree
+ * up to the requested precision share one sequence. GridSynth stores canonical angles in
+ * [0, pi/4] (see OctantReduction). The oldest entry is evicted when a new entry is inserted into a
+ * full index.
+ */
+class RotationIndex {
+public:
+    explicit RotationIndex(std::size_t capacity = 1 << 16) : capacity_(capacity) {}
+
+    /**
+     * @brief Find a stored gate approximating Rz(theta) within `epsilon`.
+     * @details Only entries whose angle is close enough to possibly qualify are checked, and the
+     * nearest one passing SquaredRzDistance is returned.
+     */
+    std::optional<Gate> Find(const Float& theta, const Float& epsilon) const;
+    /**
+     * @brief Store `gate`, which approximates Rz(theta) within `epsilon` up to global phase.
+     */
+    void Insert(const Float& theta, const Float& epsilon, Gate gate);
+    void Clear();
+    std::size_t Size() const;
+    std::size_t Capacity() const { return capacity_; }
+
+private:
+    struct Entry {
+        Complex u00;  //!< Diagonal of the exact unitary of `gate`
+        Complex u11;
+        Gate gate;
+    };
+    using Map = std::multimap<double, Entry>;
+
+    const std::size_t capacity_;
+    mutable std::mutex mtx_;
+    /// Entries keyed by the angle rounded to double
+    Map entries_;
+    /// Entries ordered from the oldest
+    std::list<Map::iterator> order_;
+    /// Largest epsilon of the stored gates, which bounds the search window
+    Float max_epsilon_ = 0;
+};
+}  // namespace qrot
+
+#endif  // QROT_ROTATION_INDEX_H
@@ -0,0 +1,49 @@
+#include "qrot/thread_pool.h"
+
+namespace qrot {
+void ThreadPool::Run(const Task& task) {
+    auto run_lock = std::unique_lock(run_mtx_, std::try_to_lock);
+    if (num_threads_ <= 1 || !run_lock.owns_lock()) {
+        task(0, 1);
+        return;
+    }
+    if (workers_.empty()) {
+        for (auto index = std::uint32_t{1}; index < num_threads_; ++index) {
+            workers_.emplace_back([this, index](std::stop_token stop) { Work(stop, index); });
+        }
+    }
+
+    {
+        const auto lock = std::lock_guard(mtx_);
+        task_ = &task;
+        running_ = num_threads_ - 1;
+        ++generation_;
+    }
+    start_cv_.notify_all();
+    // The workers hold a reference to `task`, so wait for them even if the caller's part throws
+    const auto wait = [this] {
+        auto lock = std::unique_lock(mtx_);
+        done_cv_.wait(lock, [this] { return running_ == 0; });
+    };
+    try {
+        task(0, num_threads_);
+    } catch (...) {
+        wait();
+        throw;
+    }
+    wait();
+}
+void ThreadPool::Work(std::stop_token stop, std::uint32_t index) {
+    auto seen = std::uint64_t{0};
+    while (true) {
+        auto lock = std::unique_lock(mtx_);
+        if (!start_cv_.wait(lock, stop, [&] { return generation_ != seen; })) { return; }
+        seen = generation_;
+        const auto& task = *task_;
+        lock.unlock();
+        task(index, num_threads_);
+        lock.lock();
+        if (--running_ == 0) { done_cv_.notify_one(); }
+    }
+}
+}  // namespace qrot
@@ -0,0 +1,53 @@
+#ifndef QROT_THREAD_POOL_H
+#define QROT_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace qrot {
+/**
+ * @brief Fixed number of threads running one task at a time together with the caller.
+ * @details The workers are started by the first Run and live as long as the pool, so repeated
+ * tasks do not pay for starting threads.
+ */
+class ThreadPool {
+public:
+    /// Task run as task(index, count) by `count` threads, each with a distinct index < count
+    using Task = std::function<void(std::uint32_t, std::uint32_t)>;
+
+    /**
+     * @param num_threads threads running a task, including the caller of Run
+     */
+    explicit ThreadPool(std::uint32_t num_threads) : num_threads_{num_threads} {}
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::uint32_t NumThreads() const { return num_threads_; }
+    /**
+     * @brief Run `task` on the calling thread and the workers, and wait until all of them return.
+     * @details While another Run uses the workers, task(0, 1) is run on the calling thread alone.
+     */
+    void Run(const Task& task);
+
+private:
+    void Work(std::stop_token stop, std::uint32_t index);
+
+    const std::uint32_t num_threads_;
+    std::mutex run_mtx_;  //!< Held by the Run using the workers
+    std::mutex mtx_;      //!< Guards task_, generation_ and running_
+    std::condition_variable_any start_cv_;
+    std::condition_variable done_cv_;
+    const Task* task_ = nullptr;
+    std::uint64_t generation_ = 0;  //!< Number of tasks handed to the workers
+    std::uint32_t running_ = 0;     //!< Workers still running the current task
+    /// Destroyed first, which stops and joins the workers before the rest is destroyed
+    std::vector<std::jthread> workers_;
+};
+}  // namespace qrot
+
+#endif  // QROT_THREAD_POOL_H
@@ -0,0 +1,62 @@
+#include "qrot/trace.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace qrot {
+namespace {
+/**
+ * @brief Small sequential id of the calling thread, used as its track in the trace.
+ */
+std::uint32_t ThreadId() {
+    static auto next = std::atomic<std::uint32_t>{0};
+    thread_local const auto id = next.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+}  // namespace
+
+Tracer& Tracer::Global() {
+    static auto tracer = Tracer();
+    return tracer;
+}
+void Tracer::Clear() {
+    const auto lock = std::lock_guard(mtx_);
+    events_.clear();
+}
+std::size_t Tracer::Size() const {
+    const auto lock = std::lock_guard(mtx_);
+    return events_.size();
+}
+void Tracer::Record(const char* name, Clock::time_point begin, Clock::time_point end) {
+    const auto tid = ThreadId();
+    const auto lock = std::lock_guard(mtx_);
+    events_.push_back({name, tid, begin, end});
+}
+void Tracer::Write(std::ostream& out) const {
+    using Us = std::chrono::duration<double, std::micro>;
+
+    const auto lock = std::lock_guard(mtx_);
+    auto max_tid = std::uint32_t{0};
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (auto i = std::size_t{0}; i < events_.size(); ++i) {
+        const auto& e = events_[i];
+        max_tid = std::max(max_tid, e.tid);
+        out << (i == 0 ? "" : ",") << "\n{\"name\":\"" << e.name
+            << "\",\"cat\":\"qrot\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.tid
+            << ",\"ts\":" << Us(e.begin - origin_).count()
+            << ",\"dur\":" << Us(e.end - e.begin).count() << "}";
+    }
+    // Name the track of each thread
+    for (auto tid = std::uint32_t{0}; !events_.empty() && tid <= max_tid; ++tid) {
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+            << ",\"args\":{\"name\":\"thread " << tid << "\"}}";
+    }
+    out << "\n]}\n";
+}
+bool Tracer::Write(const std::string& path) const {
+    auto ofs = std::ofstream(path);
+    if (!ofs) { return false; }
+    Write(ofs);
+    return static_cast<bool>(ofs);
+}
+}  // namespace qrot
@@ -0,0 +1,99 @@
+#ifndef QROT_TRACE_H
+#define QROT_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef QROT_OP_CENSUS
+#include "qrot/census.h"
+#endif
+
+namespace qrot {
+/**
+ * @brief Collect scoped events and write them in the Chrome trace event format.
+ * @details The output is viewable with chrome://tracing or https://ui.perfetto.dev. Each thread
+ * which records an event gets its own track. Recording is disabled until Enable is called, so a
+ * TraceScope costs one relaxed atomic load otherwise.
+ */
+class Tracer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static Tracer& Global();
+
+    void Enable() { enabled_.store(true, std::memory_order_relaxed); }
+    void Disable() { enabled_.store(false, std::memory_order_relaxed); }
+    bool Enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void Clear();
+    std::size_t Size() const;
+
+    /**
+     * @brief Record a complete event of the calling thread.
+     *
+     * @param name string with static storage duration
+     */
+    void Record(const char* name, Clock::time_point begin, Clock::time_point end);
+    void Write(std::ostream& out) const;
+    /**
+     * @return false if the file cannot be opened
+     */
+    bool Write(const std::string& path) const;
+
+private:
+    struct Event {
+        const char* name;
+        std::uint32_t tid;
+        Clock::time_point begin;
+        Clock::time_point end;
+    };
+
+    Tracer() = default;
+
+    std::atomic<bool> enabled_ = false;
+    const Clock::time_point origin_ = Clock::now();
+    mutable std::mutex mtx_;
+    std::vector<Event> events_;
+};
+
+/**
+ * @brief Record the lifetime of this object as an event named `name` if tracing is enabled.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : name_{Tracer::Global().Enabled() ? name : nullptr},
+          begin_{name_ != nullptr ? Tracer::Clock::now() : Tracer::Clock::time_point{}} {}
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+    ~TraceScope() {
+        if (name_ != nullptr) { Tracer::Global().Record(name_, begin_, Tracer::Clock::now()); }
+    }
+
+private:
+    const char* const name_;
+    const Tracer::Clock::time_point begin_;
+};
+}  // namespace qrot
+
+// Trace the enclosing scope. Compiled out unless QROT_TRACE is defined.
+// With QROT_OP_CENSUS, the scope also names the stage of the operation census.
+#ifdef QROT_TRACE
+#define QROT_TRACE_EVENT_(name) const auto qrot_trace_scope_ = ::qrot::TraceScope(name)
+#else
+#define QROT_TRACE_EVENT_(name) static_cast<void>(0)
+#endif
+#ifdef QROT_OP_CENSUS
+#define QROT_CENSUS_STAGE_(name) const auto qrot_census_stage_ = ::qrot::census::Stage(name)
+#else
+#define QROT_CENSUS_STAGE_(name) static_cast<void>(0)
+#endif
+#define QROT_TRACE_SCOPE(name) \
+    QROT_TRACE_EVENT_(name);   \
+    QROT_CENSUS_STAGE_(name)
+
+#endif  // QROT_TRACE_H
@@ -0,0 +1,118 @@
+#include "qrot/verification.h"
+
+#include <utility>
+
+#include "qrot/trace.h"
+
+namespace qrot {
+namespace {
+/// Bound of the rounding error of the trace evaluated in Float
+static inline const Float TraceMargin =
+    mp::ldexp(Float{1}, -static_cast<int>(FloatPrecision - 128));
+
+/**
+ * @brief x * omega^k for 0 <= k < 8.
+ */
+ZOmega MulOmega(const ZOmega& x, std::uint32_t k) {
+    auto ret = x;
+    for (auto i = std::uint32_t{0}; i < k % 8; ++i) {
+        ret = ZOmega(-ret.Get(3), ret.Get(0), ret.Get(1), ret.Get(2));
+    }
+    return ret;
+}
+/**
+ * @brief x / sqrt(2)^den_exp in Float.
+ */
+Complex ToComplex(const ZOmega& x, std::uint32_t den_exp) {
+    using constant::f::InvSqrt;
+    // x_0 + x_1 omega + x_2 i + x_3 omega^3 with omega = (1 + i) / sqrt(2)
+    auto real = Float(x.Get(0)) + Float(x.Get(1) - x.Get(3)) * InvSqrt;
+    auto imag = Float(x.Get(2)) + Float(x.Get(1) + x.Get(3)) * InvSqrt;
+    const auto exp = -static_cast<int>(den_exp / 2);
+    real = mp::ldexp(real, exp);
+    imag = mp::ldexp(imag, exp);
+    if (den_exp % 2 == 1) {
+        real *= InvSqrt;
+        imag *= InvSqrt;
+    }
+    return {real, imag};
+}
+}  // namespace
+
+ExactUnitary ExactUnitary::FromGate(const Gate& gate) {
+    QROT_TRACE_SCOPE("ExactUnitary::FromGate");
+    auto ret = ExactUnitary();
+    auto& m = ret.num;
+    // Right multiplication by a diagonal atom diag(1, omega^k)
+    const auto mul_col1 = [&m](std::uint32_t k) {
+        for (auto row = std::size_t{0}; row < 2; ++row) {
+            m.GetMut(row, 1) = MulOmega(m.Get(row, 1), k);
+        }
+    };
+    for (const auto a : gate) {
+        switch (a.GetType()) {
+            case Atom::Type::I: break;
+            case Atom::Type::T: mul_col1(1); break;
+            case Atom::Type::S: mul_col1(2); break;
+            case Atom::Type::Z: mul_col1(4); break;
+            case Atom::Type::W:
+                for (auto row = std::size_t{0}; row < 2; ++row) {
+                    for (auto col = std::size_t{0}; col < 2; ++col) {
+                        m.GetMut(row, col) = MulOmega(m.Get(row, col), 1);
+                    }
+                }
+                break;
+            case Atom::Type::X:
+                for (auto row = std::size_t{0}; row < 2; ++row) {
+                    std::swap(m.GetMut(row, 0), m.GetMut(row, 1));
+                }
+                break;
+            case Atom::Type::Y:
+                // [c0, c1] Y = [i c1, -i c0]
+                for (auto row = std::size_t{0}; row < 2; ++row) {
+                    auto c0 = MulOmega(m.Get(row, 1), 2);
+                    m.GetMut(row, 1) = MulOmega(m.Get(row, 0), 6);
+                    m.GetMut(row, 0) = std::move(c0);
+                }
+                break;
+            case Atom::Type::H:
+                // [c0, c1] H = [c0 + c1, c0 - c1] / sqrt(2)
+                for (auto row = std::size_t{0}; row < 2; ++row) {
+                    auto c0 = m.Get(row, 0) + m.Get(row, 1);
+                    m.GetMut(row, 1) = m.Get(row, 0) - m.Get(row, 1);
+                    m.GetMut(row, 0) = std::move(c0);
+                }
+                ret.den_exp++;
+                break;
+        }
+    }
+    return ret;
+}
+MCD2 ExactUnitary::ToMCD2() const {
+    auto ret = MCD2(ToCD2(num.Get(0, 0)), ToCD2(num.Get(0, 1)), ToCD2(num.Get(1, 0)),
+                    ToCD2(num.Get(1, 1)));
+    for (auto i = std::uint32_t{0}; i < den_exp; ++i) { ret *= constant::cd2::InvSqrt; }
+    return ret;
+}
+MatC ExactUnitary::ToMatC() const {
+    return {ToComplex(num.Get(0, 0), den_exp), ToComplex(num.Get(0, 1), den_exp),
+            ToComplex(num.Get(1, 0), den_exp), ToComplex(num.Get(1, 1), den_exp)};
+}
+
+Float SquaredRzDistance(const Complex& u00, const Complex& u11, const Float& c, const Float& s) {
+    // tr(Rz(theta)^dagger U) = (c + i s) u00 + (c - i s) u11
+    const Float re = c * (u00.real() + u11.real()) - s * (u00.imag() - u11.imag());
+    const Float im = c * (u00.imag() + u11.imag()) + s * (u00.real() - u11.real());
+    const Float squared = 2 - mp::sqrt(re * re + im * im);
+    return (squared < 0 ? Float{0} : squared) + TraceMargin;
+}
+Float RzDistance(const Gate& gate, const Float& theta) {
+    QROT_TRACE_SCOPE("RzDistance");
+    const auto u = ExactUnitary::FromGate(gate).ToMatC();
+    const Float half = theta / 2;
+    return mp::sqrt(SquaredRzDistance(u.Get(0, 0), u.Get(1, 1), mp::cos(half), mp::sin(half)));
+}
+bool VerifyRz(const Gate& gate, const Float& theta, const Float& epsilon) {
+    return RzDistance(gate, theta) <= epsilon;
+}
+}  // namespace qrot
@@ -0,0 +1,47 @@
+#ifndef QROT_VERIFICATION_H
+#define QROT_VERIFICATION_H
+
+#include <cstdint>
+
+#include "qrot/boost.h"
+#include "qrot/gate.h"
+#include "qrot/matrix.h"
+#include "qrot/number.h"
+
+namespace qrot {
+/**
+ * @brief Exact unitary of a Clifford+T gate as num / sqrt(2)^den_exp with num over Z[omega].
+ * @details All entries share one denominator exponent, so every atom acts on the columns of num
+ * by additions and coefficient rotations only: T, S, Z and W multiply by powers of omega, X and Y
+ * swap columns, and H adds and subtracts them while incrementing den_exp.
+ */
+struct ExactUnitary {
+    Matrix<ZOmega> num = Matrix<ZOmega>(1, 0, 0, 1);
+    std::uint32_t den_exp = 0;
+
+    static ExactUnitary FromGate(const Gate& gate);
+    MCD2 ToMCD2() const;
+    MatC ToMatC() const;
+};
+
+/**
+ * @brief Certified upper bound of min_phi ||e^{i phi} U - Rz(theta)||^2 from the diagonal of U.
+ * @details For unitary U and W = Rz(theta)^dagger U, the distance up to global phase is
+ * \sqrt{2 - |tr W|}, and tr W = e^{i theta / 2} u00 + e^{-i theta / 2} u11. The cosine c and sine
+ * s of theta / 2 are passed so that many unitaries can be checked against one angle. The bound
+ * exceeds the exact value by at most 2^{-(FloatPrecision - 128)}.
+ */
+Float SquaredRzDistance(const Complex& u00, const Complex& u11, const Float& c, const Float& s);
+/**
+ * @brief Certified upper bound of the operator norm ||gate - Rz(theta)|| up to global phase.
+ * @details See SquaredRzDistance. The exact output of GridSynth for an odd multiple of pi/4 is
+ * e^{i pi / 8} Rz(theta), which is at distance 0.
+ */
+Float RzDistance(const Gate& gate, const Float& theta);
+/**
+ * @brief Check ||gate - Rz(theta)|| <= epsilon up to global phase with RzDistance.
+ */
+bool VerifyRz(const Gate& gate, const Float& theta, const Float& epsilon);
+}  // namespace qrot
+
+#endif  // QROT_VERIFICATION_H
@@ -0,0 +1,48 @@
+#include "qrot/cache.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace qrot;
+
+TEST(BoundedCache, GetPut) {
+    auto cache = BoundedCache<int, std::string>(2);
+    EXPECT_FALSE(cache.Get(1).has_value());
+    cache.Put(1, "a");
+    cache.Put(2, "b");
+    EXPECT_EQ("a", cache.Get(1));
+    EXPECT_EQ(2, cache.Size());
+
+    // 2 is the least recently used
+    cache.Put(3, "c");
+    EXPECT_EQ(2, cache.Size());
+    EXPECT_FALSE(cache.Get(2).has_value());
+    EXPECT_EQ("a", cache.Get(1));
+    EXPECT_EQ("c", cache.Get(3));
+
+    cache.Put(1, "d");
+    EXPECT_EQ("d", cache.Get(1));
+    cache.Clear();
+    EXPECT_EQ(0, cache.Size());
+    EXPECT_FALSE(cache.Get(1).has_value());
+}
+TEST(BoundedCache, Concurrent) {
+    constexpr auto NumThreads = 4;
+    constexpr auto NumKeys = 1000;
+    auto cache = BoundedCache<int, int>(NumKeys / 2);
+    {
+        auto threads = std::vector<std::jthread>();
+        for (auto i = 0; i < NumThreads; ++i) {
+            threads.emplace_back([&cache] {
+                for (auto key = 0; key < NumKeys; ++key) {
+                    if (const auto value = cache.Get(key)) { EXPECT_EQ(2 * key, *value); }
+                    cache.Put(key, 2 * key);
+                }
+            });
+        }
+    }
+    EXPECT_EQ(NumKeys / 2, cache.Size());
+}
@@ -95,3 +95,89 @@ TEST(Diophantine, SolveEasy) {
     EXPECT_EQ(g, (actual_t * actual_t.Adj()).Real());
     EXPECT_EQ(CD2(1), u * u.Adj() + actual_t * actual_t.Adj());
 }
+TEST(Diophantine, FactorizeBatch) {
+    auto dio = Diophantine();
+    const auto p1 = Integer(2);
+    const auto p2 = Integer(9999991);
+    const auto p3 = Integer("2586442777");
+    const auto ns = std::vector<Integer>{1, p1 * p1 * p2, p2 * p3 * p3, p3};
+    auto facs = std::vector<std::unordered_map<Integer, std::uint32_t>>();
+    dio.FactorizeIntoPrime(ns, facs);
+    ASSERT_EQ(ns.size(), facs.size());
+    EXPECT_TRUE(facs[0].empty());
+    EXPECT_EQ(2, facs[1].size());
+    EXPECT_EQ(2, facs[1].at(p1));
+    EXPECT_EQ(1, facs[1].at(p2));
+    EXPECT_EQ(2, facs[2].size());
+    EXPECT_EQ(1, facs[2].at(p2));
+    EXPECT_EQ(2, facs[2].at(p3));
+    EXPECT_EQ(1, facs[3].size());
+    EXPECT_EQ(1, facs[3].at(p3));
+}
+TEST(Diophantine, FactorizeDirectAndTree) {
+    // A batch above the size limit of the direct remainders goes through the remainder tree, while
+    // each element alone is factorized directly
+    auto dio = Diophantine();
+    const auto m521 = (Integer(1) << 521) - 1;
+    const auto small = std::vector<Integer>{2, 3, 65537, 9999971, 9999973, 9999991};
+    auto ns = std::vector<Integer>();
+    for (auto i = std::size_t{0}; i < 10; ++i) {
+        auto n = m521;
+        for (auto j = std::size_t{0}; j <= i; ++j) { n *= small[(i + j) % small.size()]; }
+        ns.emplace_back(n);
+    }
+    auto facs = std::vector<std::unordered_map<Integer, std::uint32_t>>();
+    dio.FactorizeIntoPrime(ns, facs);
+    ASSERT_EQ(ns.size(), facs.size());
+    for (auto i = std::size_t{0}; i < ns.size(); ++i) {
+        auto fac = std::unordered_map<Integer, std::uint32_t>();
+        dio.FactorizeIntoPrime(ns[i], fac);
+        EXPECT_EQ(facs[i], fac) << i;
+        EXPECT_EQ(1, fac.at(m521)) << i;
+        auto product = Integer(1);
+        for (const auto& [p, e] : fac) { product *= mp::pow(p, e); }
+        EXPECT_EQ(ns[i], product) << i;
+    }
+}
+TEST(Diophantine, SolveFirst) {
+    auto dio = Diophantine();
+    const auto u = CD2(D2(DyadicFraction(-1, 2)), D2(DyadicFraction(-3, 2)));
+    const auto g = D2(1) - (u * u.Adj()).Real();
+    // 3 + \sqrt{2} (norm 7) and -1 have no solution
+    const auto gs = std::vector<D2>{D2(3, 1), D2(-1), g, D2(1)};
+    auto actual_t = CD2();
+    EXPECT_EQ(2, dio.SolveFirst(gs, actual_t));
+    EXPECT_EQ(g, (actual_t * actual_t.Adj()).Real());
+    EXPECT_EQ(1, dio.SolveFirst({D2(3, 1)}, actual_t));
+
+    // Factorizations and split primes are reused
+    auto cached_t = CD2();
+    EXPECT_EQ(2, dio.SolveFirst(gs, cached_t));
+    EXPECT_EQ(actual_t, cached_t);
+}
+TEST(Diophantine, ZeroNorm) {
+    // xi = 0 when u is a unit, and t = 0 is the solution
+    auto dio = Diophantine();
+    auto t = CD2(1);
+    EXPECT_TRUE(dio.Solve(D2(0), t));
+    EXPECT_EQ(CD2(0), t);
+
+    auto stats = Diophantine::Stats();
+    t = CD2(1);
+    EXPECT_EQ(1, dio.SolveFirst({D2(3, 1), D2(0), D2(1)}, t, stats));
+    EXPECT_EQ(CD2(0), t);
+    EXPECT_EQ(2, stats.tried);
+
+    // Batches on both the direct and the remainder tree path
+    const auto m521 = (Integer(1) << 521) - 1;
+    for (const auto size : {std::size_t{2}, std::size_t{16}}) {
+        auto ns = std::vector<Integer>(size, m521 * 6);
+        ns[0] = 0;
+        auto facs = std::vector<std::unordered_map<Integer, std::uint32_t>>();
+        dio.FactorizeIntoPrime(ns, facs);
+        ASSERT_EQ(size, facs.size());
+        EXPECT_TRUE(facs[0].empty());
+        EXPECT_EQ(3, facs[1].size());
+        EXPECT_EQ(1, facs[1].at(m521));
+    }
+}
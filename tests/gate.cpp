@@ -2,7 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <limits>
 #include <queue>
+#include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -21,10 +24,69 @@ TEST(Gate, HS) {
     EXPECT_EQ(Z, Gate::FromString("SS").Mat());
     EXPECT_EQ(W, Gate::FromString("HSHSHS").Mat());
 }
+TEST(Gate, PackedStorage) {
+    using namespace constant::gate;
+    auto str = std::string();
+    for (auto i = 0; i < 20; ++i) { str += "HTSHTXYZWI"; }
+    const auto gate = Gate::FromString(str);
+    EXPECT_EQ(str.size(), gate.Size());
+    EXPECT_EQ(40, gate.CountT());
+    EXPECT_EQ(str, gate.ToString());
+    auto ss = std::stringstream();
+    ss << gate;
+    EXPECT_EQ(str, ss.str());
+    EXPECT_FALSE(gate.IsClifford());
+    EXPECT_TRUE(Gate::FromString("HSXYZW").IsClifford());
+
+    // Concatenation across word boundaries
+    for (auto n = std::size_t{0}; n < 50; ++n) {
+        const auto prefix = Gate::FromString(str.substr(0, n));
+        const auto expected = str.substr(0, n) + str;
+        EXPECT_EQ(Gate::FromString(expected), prefix * gate);
+        EXPECT_EQ(Gate::FromString(expected), Gate(prefix) * gate);
+        EXPECT_EQ(Gate::FromString(expected).CountT(), (prefix * gate).CountT());
+    }
+    EXPECT_EQ(Gate::FromString("T" + str), T * gate);
+    EXPECT_EQ(Gate::FromString(str + "T"), gate * T);
+
+    // Pop
+    auto tmp = gate;
+    for (auto n = str.size(); n > 0; --n) {
+        EXPECT_EQ(gate.Get(n - 1), tmp.Back());
+        tmp.PopBack();
+        EXPECT_EQ(Gate::FromString(str.substr(0, n - 1)), tmp);
+        EXPECT_EQ(Gate::FromString(str.substr(0, n - 1)).CountT(), tmp.CountT());
+    }
+    EXPECT_TRUE(tmp.Empty());
+    EXPECT_EQ("I", tmp.ToString());
+}
 TEST(CliffordDatabase, Ctor) {
     using constant::mcd2::H, constant::mcd2::S;
     auto database = CliffordDatabase();
 }
+TEST(CliffordDatabase, Tables) {
+    using constant::mcd2::T, constant::mcd2::TDag;
+    using DB = CliffordDatabase;
+    auto mats = std::vector<MCD2>();
+    for (auto i = std::size_t{0}; i < DB::NumElements; ++i) {
+        mats.emplace_back(DB::GetMatrix(i));
+        EXPECT_EQ(i, DB::SearchIndex(mats.back()));
+        EXPECT_EQ(mats.back(), DB::GetGate(i).Mat());
+        EXPECT_EQ(i, DB::SearchIndex(DB::GetGate(i)));
+    }
+    EXPECT_EQ(std::numeric_limits<std::size_t>::max(), DB::SearchIndex(T));
+    for (auto i = std::size_t{0}; i < DB::NumElements; ++i) {
+        for (const auto a : Gate::FromString("IHSXYZW")) {
+            EXPECT_EQ(mats[i] * a.Mat(), mats[DB::Multiply(i, a)]);
+        }
+        for (auto j = std::size_t{0}; j < DB::NumElements; j += 7) {
+            EXPECT_EQ(mats[i] * mats[j], mats[DB::Multiply(i, j)]);
+        }
+    }
+    for (auto i = std::size_t{0}; i < DB::NumCT; ++i) {
+        EXPECT_EQ(TDag * mats[i] * T, mats[DB::GetTMove(i)]);
+    }
+}
 TEST(Gate, Normalize) {
     // Example from https://www.mathstat.dal.ca/~selinger/newsynth/
     const auto input = std::string(
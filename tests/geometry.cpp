@@ -67,3 +67,41 @@ TEST(Ellipse, FromCircle) {
     MY_EXPECT_FLOAT_EQ(-5 - 10, bbox.y_min);
     MY_EXPECT_FLOAT_EQ(-5 + 10, bbox.y_max);
 }
+TEST(Ellipse, YRange) {
+    // 5 x^2 - 6xy + 5 y^2 = 8 centered at (1.5, 1.5)
+    const auto ellipse = Ellipse::FromRectangle(Vec(1, 0), Vec(0, 1), Vec(2, 3), Vec(3, 2));
+    const auto c = Float("1.5");
+    const auto tol = Float("1e-5");
+    // Exact range at x = c + u is c + 0.6 u +- 0.8 \sqrt{2.5 - u^2}
+    for (const auto& u : {Float{0}, Float("0.5"), Float("-1.2"), Float("1.58")}) {
+        const auto range = ellipse.YRange(c + u);
+        ASSERT_TRUE(range.has_value());
+        const Float mid = c + Float("0.6") * u;
+        const Float half = Float("0.8") * mp::sqrt(Float("2.5") - u * u);
+        EXPECT_LE(range->first, mid - half);
+        EXPECT_GE(range->first, mid - half - tol);
+        EXPECT_GE(range->second, mid + half);
+        EXPECT_LE(range->second, mid + half + tol);
+    }
+    EXPECT_FALSE(ellipse.YRange(c + Float("1.6")).has_value());
+    EXPECT_FALSE(ellipse.YRange(c - 5).has_value());
+}
+TEST(Ellipse, XRange) {
+    // (x - 1)^2 / 4 + (y + 2)^2 / 9 <= 1, i.e. x = 1 +- 2 \sqrt{1 - (y + 2)^2 / 9}
+    const auto ellipse =
+        Ellipse(Vec(1, -2), mp::sqrt(Float{6}), Float{9} / 6, Float{0}, Float{4} / 6);
+    const auto tol = Float("1e-5");
+    for (const auto& v : {Float{0}, Float("1.5"), Float("-2.9")}) {
+        const auto range = ellipse.XRange(Float(-2 + v));
+        ASSERT_TRUE(range.has_value());
+        const Float half = 2 * mp::sqrt(1 - v * v / 9);
+        const Float min = 1 - half;
+        const Float max = 1 + half;
+        EXPECT_LE(range->first, min);
+        EXPECT_GE(range->first, min - tol);
+        EXPECT_GE(range->second, max);
+        EXPECT_LE(range->second, max + tol);
+    }
+    EXPECT_FALSE(ellipse.XRange(Float("1.1")).has_value());
+    EXPECT_FALSE(ellipse.XRange(Float{-6}).has_value());
+}
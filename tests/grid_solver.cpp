@@ -2,12 +2,16 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
 #include <numbers>
+#include <vector>
 
 #include "qrot/decomposition.h"
 #include "qrot/diophantine.h"
 #include "qrot/matrix.h"
 #include "qrot/number.h"
+#include "qrot/parser.h"
 
 using namespace qrot;
 
@@ -43,7 +47,184 @@ TEST(GridSolver, OneDim) {
     TestOneDimGrid(0.0, 1.1 + std::sqrt(2), 1, 28.1 + std::sqrt(2));
     TestOneDimGrid(1.0, 2.1 + std::sqrt(2), 1, 2.1 + std::sqrt(2));
 }
+TEST(GridSolver, OneDimComplete) {
+    // Compare with the brute force over b and then a, including endpoints just outside grid points,
+    // for which the double-precision filter defers to the exact check
+    using constant::f::Sqrt;
+    const auto brute_force = [](const Float& x0, const Float& x1, const Float& y0,
+                                const Float& y1) {
+        auto ret = std::vector<Z2>();
+        const auto min_b = static_cast<Integer>(mp::floor((x0 - y1) / (2 * Sqrt)));
+        const auto max_b = static_cast<Integer>(mp::ceil((x1 - y0) / (2 * Sqrt)));
+        for (auto b = min_b; b <= max_b; ++b) {
+            const auto min_a = static_cast<Integer>(mp::ceil(x0 - Float(b) * Sqrt));
+            const auto max_a = static_cast<Integer>(mp::floor(x1 - Float(b) * Sqrt));
+            for (auto a = min_a; a <= max_a; ++a) {
+                const auto x = Z2(a, b);
+                const auto y = x.Adj2().ToFloat();
+                if (y0 <= y && y <= y1) { ret.emplace_back(x); }
+            }
+        }
+        return ret;
+    };
+    const auto delta = Float("1e-13");
+    const auto lower = [&](std::int32_t a, std::int32_t b) { return Z2(a, b).ToFloat() - delta; };
+    const auto upper = [&](std::int32_t a, std::int32_t b) { return Z2(a, b).ToFloat() + delta; };
+    const auto intervals = std::vector<std::array<Float, 4>>{
+        {Float{0.2}, Float{7.5}, Float{-3.3}, Float{4.1}},
+        {Float{-100.7}, Float{-99.9}, Float{-30}, Float{40}},
+        {lower(3, -2), upper(9, 1), lower(-5, 4), upper(7, 3)},
+        {lower(1, 1), upper(2, 1), lower(1, -1), upper(40, -1)},
+        {Float{1e6}, Float{1e6} + Float{1e-3}, Float{-1e4}, Float{1e4}},
+        {lower(1000, 700), upper(1001, 700), lower(-300, 50), upper(3000, 50)},
+    };
+    for (const auto& [x0, x1, y0, y1] : intervals) {
+        auto solver = OneDimGridSolver(x0, x1, y0, y1);
+        solver.EnumerateAllSolutions();
+        const auto expected = brute_force(x0, x1, y0, y1);
+        const auto& actual = solver.GetSolutions();
+        EXPECT_EQ(expected.size(), actual.size()) << x0 << ' ' << x1;
+        for (const auto& x : expected) {
+            EXPECT_NE(std::find(actual.begin(), actual.end(), x), actual.end()) << x;
+        }
+    }
+}
+TEST(GridSolver, OneDimMaxCount) {
+    auto all = OneDimGridSolver(0.0, 30.0, -30.0, 30.0);
+    all.EnumerateAllSolutions();
+    const auto& expected = all.GetSolutions();
+    ASSERT_GT(expected.size(), 5);
+    for (const auto max_count : {std::size_t{0}, std::size_t{5}, expected.size() + 1}) {
+        auto solver = OneDimGridSolver(0.0, 30.0, -30.0, 30.0);
+        solver.EnumerateSolutions(max_count);
+        const auto& actual = solver.GetSolutions();
+        EXPECT_EQ(std::min(max_count, expected.size()), actual.size());
+        for (const auto& x : actual) {
+            EXPECT_NE(std::find(expected.begin(), expected.end(), x), expected.end()) << x;
+        }
+    }
+}
 TEST(GridSolver, TwoDim) {
     TestTwoDimGrid(std::numbers::pi / 128, 0.000001);
     EXPECT_EQ(0, 0);
 }
+TEST(GridSolver, NearOddQuarterTurns) {
+    // The grid operator search used to cycle between K and B for these angles
+    for (const auto search : {GridOperatorSearch::Step, GridOperatorSearch::Lattice}) {
+        for (const auto* theta :
+             {"-pi/4-0.0001", "3*pi/4+0.0001", "-pi/2+0.0001", "-pi/4+0.01"}) {
+            const auto value = -AST::Parse(theta).Value() / Float{2};
+            auto solver = TwoDimGridSolver::New(value, Float("1e-30"), search);
+            solver.EnumerateAllSolutions();
+            auto level = 0;
+            while (solver.GetSolutions().empty() && level++ < 64) {
+                solver.EnumerateNextLevelAllSolutions();
+            }
+            EXPECT_FALSE(solver.GetSolutions().empty()) << theta;
+        }
+    }
+}
+TEST(GridSolver, SolutionsInEpsilonRegion) {
+    // el1 only covers the circular segment, so candidates in el1 outside it must be rejected
+    const auto epsilon = Float("1e-20");
+    const auto theta = AST::Parse("1.987654").Value() / Float{2};
+    auto solver = TwoDimGridSolver::New(theta, epsilon);
+    solver.EnumerateAllSolutions();
+    for (auto i = 0; i < 3; ++i) {
+        for (const auto& u : solver.GetSolutions()) {
+            const Float proj = u.Real().ToFloat() * mp::cos(theta) +
+                               u.Imag().ToFloat() * mp::sin(theta);
+            EXPECT_GE(proj, 1 - epsilon * epsilon / 2);
+            EXPECT_LE(u.Norm(), D2(1));
+        }
+        solver.EnumerateNextLevelAllSolutions();
+    }
+}
+TEST(GridSolver, LatticeGridOperator) {
+    // Solutions of a level are the points of Z[omega] / \sqrt{2}^level in the region, whichever
+    // grid operator enumerates them
+    const auto contains = [](const std::vector<CD2>& solutions, const CD2& u) {
+        return std::find(solutions.begin(), solutions.end(), u) != solutions.end();
+    };
+    for (const auto* theta : {"pi/128", "0.3", "-1.2"}) {
+        for (const auto* epsilon : {"1e-5", "1e-25"}) {
+            const auto value = -AST::Parse(theta).Value() / Float{2};
+            const auto eps = Float(epsilon);
+            auto step = TwoDimGridSolver::New(value, eps, GridOperatorSearch::Step);
+            auto lattice = TwoDimGridSolver::New(value, eps, GridOperatorSearch::Lattice);
+            step.EnumerateAllSolutions();
+            lattice.EnumerateAllSolutions();
+            while (step.Level() < lattice.Level()) { step.EnumerateNextLevelAllSolutions(); }
+            while (lattice.Level() < step.Level()) { lattice.EnumerateNextLevelAllSolutions(); }
+            for (auto i = 0; i < 2; ++i) {
+                step.EnumerateNextLevelAllSolutions();
+                lattice.EnumerateNextLevelAllSolutions();
+                const auto& expected = step.GetSolutions();
+                const auto& actual = lattice.GetSolutions();
+                EXPECT_EQ(expected.size(), actual.size()) << theta << ' ' << epsilon;
+                for (const auto& u : actual) {
+                    EXPECT_TRUE(contains(expected, u)) << theta << ' ' << epsilon;
+                }
+            }
+        }
+    }
+}
+TEST(GridSolver, NextLevelSkipsPreviousLevel) {
+    // Whether u is in Z[omega] / \sqrt{2}^level
+    const auto on_level = [](CD2 u, std::uint32_t level) {
+        for (auto i = std::uint32_t{0}; i < level; ++i) { u *= constant::cd2::Sqrt; }
+        const auto is_z2 = [](const D2& x) { return x.Int().IsInteger() && x.Sqrt().IsInteger(); };
+        const auto v = u - constant::cd2::Omega;
+        return (is_z2(u.Real()) && is_z2(u.Imag())) || (is_z2(v.Real()) && is_z2(v.Imag()));
+    };
+    auto solver = TwoDimGridSolver::New(-Float{std::numbers::pi / 128} / 2, Float("1e-10"));
+    solver.EnumerateAllSolutions();
+    const auto first_level = solver.Level();
+    const auto first = solver.GetSolutions();
+    for (const auto& u : first) { EXPECT_TRUE(on_level(u, first_level)); }
+
+    for (auto i = 0; i < 3; ++i) {
+        solver.EnumerateNextLevelAllSolutions();
+        EXPECT_FALSE(solver.GetSolutions().empty());
+        for (const auto& u : solver.GetSolutions()) {
+            EXPECT_TRUE(on_level(u, solver.Level()));
+            EXPECT_FALSE(on_level(u, solver.Level() - 1));
+        }
+    }
+}
+TEST(GridSolver, NextLevelAfterTruncatedLevel) {
+    const auto on_level = [](CD2 u, std::uint32_t level) {
+        for (auto i = std::uint32_t{0}; i < level; ++i) { u *= constant::cd2::Sqrt; }
+        const auto is_z2 = [](const D2& x) { return x.Int().IsInteger() && x.Sqrt().IsInteger(); };
+        const auto v = u - constant::cd2::Omega;
+        return (is_z2(u.Real()) && is_z2(u.Imag())) || (is_z2(v.Real()) && is_z2(v.Imag()));
+    };
+    // Close to 0 the levels have far more solutions than MaxSolutionsPerLevel
+    auto solver = TwoDimGridSolver::New(-Float("3e-10") / 2, Float("1e-10"));
+    solver.EnumerateAllSolutions();
+    while (solver.GetSolutions().size() < TwoDimGridSolver::MaxSolutionsPerLevel &&
+           solver.Level() < 200) {
+        solver.EnumerateNextLevelAllSolutions();
+    }
+    ASSERT_GE(solver.GetSolutions().size(), TwoDimGridSolver::MaxSolutionsPerLevel);
+
+    // The level stopped early, so the next level must not skip its points
+    solver.EnumerateNextLevelAllSolutions();
+    const auto& solutions = solver.GetSolutions();
+    EXPECT_TRUE(std::any_of(solutions.begin(), solutions.end(),
+                            [&](const CD2& u) { return on_level(u, solver.Level() - 1); }));
+}
+TEST(GridSolver, LambdaPowers) {
+    auto powers = LambdaPowers();
+    for (const auto n : {0, 1, 5, 40, -1, -7, -40}) {
+        const auto approx = powers.Approx(n);
+        EXPECT_LT(mp::abs(approx / mp::pow(constant::f::Lambda, n) - 1), Float("1e-500")) << n;
+        const auto exact = powers.Exact(n);
+        EXPECT_EQ(Z2{1}, exact * powers.Exact(-n)) << n;
+        // a + b \sqrt{2} cancels for negative n
+        EXPECT_LT(mp::abs(exact.ToFloat() / approx - 1), Float("1e-400")) << n;
+    }
+    // Intervals whose widths need many lambda steps
+    TestOneDimGrid(0.0, 30.0, -1.0, 1.0);
+    TestOneDimGrid(1.0, 1.0 + 1e-3, -1e4, 1e4);
+}
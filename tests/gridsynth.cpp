@@ -0,0 +1,156 @@
+#include "qrot/gridsynth.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <string>
+
+#include "qrot/parser.h"
+
+using namespace qrot;
+
+TEST(GridSynth, Stats) {
+    const auto theta = AST::Parse("pi/128").Value();
+    const auto [gate, stats] = GridSynth(theta, 10);
+
+    EXPECT_EQ(102, gate.CountT());
+    EXPECT_EQ(gate.CountT(), stats.t_count);
+    EXPECT_GE(stats.candidates_enumerated, stats.candidates_tried);
+    EXPECT_EQ(stats.candidates_tried, stats.candidates_rejected + 1);
+    EXPECT_GT(stats.max_norm_bits, 0);
+    EXPECT_GT(stats.max_coefficient_bits, 0);
+    EXPECT_LE(stats.reduction_ms + stats.setup_ms + stats.grid_operator_ms +
+                  stats.enumeration_ms + stats.diophantine_ms + stats.decomposition_ms +
+                  stats.normalization_ms,
+              stats.total_ms * 1.001);
+
+    const auto json = stats.ToJson();
+    EXPECT_EQ('{', json.front());
+    EXPECT_EQ('}', json.back());
+    for (const auto* key :
+         {"\"reduction_ms\":", "\"setup_ms\":", "\"level\":", "\"candidates_tried\":",
+          "\"factorization_failures\":", "\"max_norm_bits\":", "\"t_count\":"}) {
+        EXPECT_NE(std::string::npos, json.find(key)) << key;
+    }
+}
+TEST(GridSynth, SharedCache) {
+    // The second call reuses the solvers and the norm factorizations of the first one
+    const auto theta = AST::Parse("0.3141").Value();
+    const auto [first_gate, first] = GridSynth(theta, 15);
+    const auto [second_gate, second] = GridSynth(theta, 15);
+    EXPECT_EQ(first_gate, second_gate);
+    EXPECT_EQ(first.candidates_tried, second.candidates_tried);
+    EXPECT_GT(second.cache_hits, 0);
+    EXPECT_GE(second.cache_hits, second.candidates_tried);
+    EXPECT_LT(second.setup_ms, 1);
+}
+TEST(GridSynth, ExactRz) {
+    using C = std::complex<double>;
+    const auto to_complex = [](const CD2& x) {
+        return C(static_cast<double>(x.Real().ToFloat()), static_cast<double>(x.Imag().ToFloat()));
+    };
+    for (auto k = -16; k <= 16; ++k) {
+        const auto gate = ExactRz(Rational(k, 4));
+        ASSERT_TRUE(gate.has_value());
+        EXPECT_EQ(static_cast<std::size_t>(k % 2 != 0), gate->CountT());
+
+        // gate = e^{i pi / 8} Rz(k pi / 4) for odd k
+        const auto mat = gate->Mat();
+        const auto angle = k * std::numbers::pi / 4;
+        const auto phase = k % 2 == 0 ? C(1) : std::polar(1.0, std::numbers::pi / 8);
+        EXPECT_NEAR(0, std::abs(to_complex(mat.Get(0, 1))), 1e-12);
+        EXPECT_NEAR(0, std::abs(to_complex(mat.Get(1, 0))), 1e-12);
+        EXPECT_NEAR(0, std::abs(to_complex(mat.Get(0, 0)) - phase * std::polar(1.0, -angle / 2)),
+                    1e-12);
+        EXPECT_NEAR(0, std::abs(to_complex(mat.Get(1, 1)) - phase * std::polar(1.0, angle / 2)),
+                    1e-12);
+    }
+    EXPECT_FALSE(ExactRz(Rational(1, 8)).has_value());
+
+    const auto [gate, stats] = GridSynth(AST::Parse("3*pi/4"), 100);
+    EXPECT_EQ(1, gate.CountT());
+    EXPECT_EQ(0, stats.candidates_enumerated);
+}
+TEST(GridSynth, NearCliffordDecimals) {
+    using C = std::complex<double>;
+    const auto to_complex = [](const CD2& x) {
+        return C(static_cast<double>(x.Real().ToFloat()), static_cast<double>(x.Imag().ToFloat()));
+    };
+    // Decimal angles within epsilon of multiples of pi/4 are not recognized by the parser
+    for (const auto* angle : {"0.0000000000001", "-0.0000000000001", "0.7853981634",
+                              "pi/4+0.000000000001", "1.5707963267948966",
+                              "3.14159265358979323846", "-2.356194490192345"}) {
+        const auto theta = AST::Parse(angle).Value();
+        const auto [gate, stats] = GridSynth(theta, 10);
+        EXPECT_LE(gate.CountT(), 1) << angle;
+        EXPECT_EQ(0, stats.candidates_enumerated) << angle;
+
+        // |tr(Rz(theta)^dagger U)| / 2 = 1 up to the error of the approximation
+        const auto mat = gate.Mat();
+        const auto t = static_cast<double>(theta);
+        const auto tr = std::polar(1.0, t / 2) * to_complex(mat.Get(0, 0)) +
+                        std::polar(1.0, -t / 2) * to_complex(mat.Get(1, 1));
+        EXPECT_NEAR(1, std::abs(tr) / 2, 1e-12) << angle;
+    }
+}
+TEST(GridSynth, NearCliffordThreshold) {
+    // A few epsilon away from multiples of pi/4, the first levels with solutions have billions
+    const auto epsilon = Float("1e-10");
+    for (const auto* angle : {"0.0000000003", "-0.000000001", "pi/4+0.000000001",
+                              "pi/2-0.0000000005"}) {
+        const auto theta = AST::Parse(angle).Value();
+        const auto [gate, stats] = GridSynth(theta, 10);
+        EXPECT_GT(gate.CountT(), 1) << angle;
+        EXPECT_GT(stats.candidates_enumerated, 0) << angle;
+
+        // |tr(Rz(theta)^dagger U)| / 2 = |Re(u e^{i theta / 2})| >= 1 - epsilon^2 / 2
+        const auto mat = gate.Mat();
+        const auto& a = mat.Get(0, 0);
+        const auto& d = mat.Get(1, 1);
+        const Float c = mp::cos(theta / 2);
+        const Float s = mp::sin(theta / 2);
+        const Float re = c * (a.Real().ToFloat() + d.Real().ToFloat()) -
+                         s * (a.Imag().ToFloat() - d.Imag().ToFloat());
+        const Float im = c * (a.Imag().ToFloat() + d.Imag().ToFloat()) +
+                         s * (a.Real().ToFloat() - d.Real().ToFloat());
+        const Float min_proj = 1 - epsilon * epsilon / 2;
+        EXPECT_GE(mp::sqrt(re * re + im * im) / 2, min_proj) << angle;
+    }
+}
+TEST(GridSynth, OctantReduction) {
+    using C = std::complex<double>;
+    const auto to_complex = [](const CD2& x) {
+        return C(static_cast<double>(x.Real().ToFloat()), static_cast<double>(x.Imag().ToFloat()));
+    };
+    const auto pi = constant::f::Pi;
+
+    const auto identity = OctantReduction::New(pi / 7);
+    EXPECT_EQ(pi / 7, identity.theta);
+    EXPECT_EQ(0, identity.quarter_turns);
+    EXPECT_FALSE(identity.reflected);
+
+    const auto reduced = OctantReduction::New(-5 * pi / 2 - pi / 7);
+    EXPECT_LT(mp::abs(reduced.theta - pi / 7), Float("1e-500"));
+    EXPECT_EQ(3, reduced.quarter_turns);
+    EXPECT_TRUE(reduced.reflected);
+
+    // Images of pi/7 under Clifford symmetries yield the same T-count
+    const auto [base, base_stats] = GridSynth(pi / 7, 10);
+    for (const auto* angle : {"pi/7", "-pi/7", "pi/2-pi/7", "pi/2+pi/7", "pi-pi/7", "-pi-pi/7",
+                              "3*pi/2+pi/7", "-7*pi/2-pi/7"}) {
+        const auto theta = AST::Parse(angle).Value();
+        const auto octant = OctantReduction::New(theta);
+        EXPECT_LT(mp::abs(octant.theta - pi / 7), Float("1e-500")) << angle;
+        const auto [gate, stats] = GridSynth(theta, 10);
+        EXPECT_EQ(base.CountT(), gate.CountT()) << angle;
+
+        // |tr(Rz(theta)^dagger U)| / 2 = 1 up to the error of the approximation
+        const auto mat = gate.Mat();
+        const auto t = static_cast<double>(theta);
+        const auto tr = std::polar(1.0, t / 2) * to_complex(mat.Get(0, 0)) +
+                        std::polar(1.0, -t / 2) * to_complex(mat.Get(1, 1));
+        EXPECT_NEAR(1, std::abs(tr) / 2, 1e-12) << angle;
+    }
+}
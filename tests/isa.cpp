@@ -0,0 +1,64 @@
+#include "qrot/isa.h"
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include "qrot/diophantine.h"
+#include "qrot/grid_solver.h"
+
+using namespace qrot;
+
+namespace {
+/// Isa of every kernel variant runnable on this CPU
+std::vector<Isa> SupportedIsas() {
+    auto ret = std::vector<Isa>();
+    for (const auto isa : {Isa::Scalar, Isa::AVX2, Isa::AVX512}) {
+        if (isa <= DetectIsa()) { ret.emplace_back(isa); }
+    }
+    return ret;
+}
+}  // namespace
+
+TEST(Isa, Parse) {
+    for (const auto isa : {Isa::Scalar, Isa::AVX2, Isa::AVX512}) {
+        EXPECT_EQ(isa, ParseIsa(ToString(isa)));
+    }
+    EXPECT_FALSE(ParseIsa("sse4").has_value());
+    EXPECT_FALSE(ParseIsa("").has_value());
+}
+TEST(Isa, SetActiveIsa) {
+    const auto original = ActiveIsa();
+    EXPECT_LE(original, DetectIsa());
+    EXPECT_EQ(Isa::Scalar, SetActiveIsa(Isa::Scalar));
+    EXPECT_EQ(Isa::Scalar, ActiveIsa());
+    EXPECT_EQ(DetectIsa(), SetActiveIsa(Isa::AVX512));
+    EXPECT_EQ(DetectIsa(), ActiveIsa());
+    SetActiveIsa(original);
+}
+TEST(Isa, KernelsAgree) {
+    const auto original = ActiveIsa();
+
+    auto solutions = std::vector<std::vector<Z2>>();
+    auto facs = std::vector<std::unordered_map<Integer, std::uint32_t>>();
+    auto dio = Diophantine();
+    const auto n = Integer(9999991) * Integer(65537) * 65537 * ((Integer(1) << 127) - 1);
+    for (const auto isa : SupportedIsas()) {
+        EXPECT_EQ(isa, SetActiveIsa(isa));
+        auto solver = OneDimGridSolver(-1000.25, 1000.5, -3.75, 2.125);
+        solver.EnumerateAllSolutions();
+        solutions.emplace_back(solver.GetSolutions());
+        auto& fac = facs.emplace_back();
+        dio.FactorizeIntoPrime(n, fac);
+    }
+    SetActiveIsa(original);
+
+    EXPECT_FALSE(solutions.front().empty());
+    EXPECT_EQ(2, facs.front().at(65537));
+    EXPECT_EQ(1, facs.front().at(9999991));
+    for (auto i = std::size_t{1}; i < solutions.size(); ++i) {
+        EXPECT_EQ(solutions.front(), solutions[i]) << ToString(SupportedIsas()[i]);
+        EXPECT_EQ(facs.front(), facs[i]) << ToString(SupportedIsas()[i]);
+    }
+}
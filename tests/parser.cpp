@@ -18,6 +18,20 @@ TEST(Parser, Value) {
     EXPECT_DOUBLE_EQ(10, static_cast<double>(AST::Parse("-10+20").Value()));
     EXPECT_DOUBLE_EQ(-1.28, static_cast<double>(AST::Parse("-1.28").Value()));
 }
+TEST(Parser, PiMultiple) {
+    EXPECT_EQ(Rational(1, 4), AST::Parse("pi/4").PiMultiple());
+    EXPECT_EQ(Rational(3, 2), AST::Parse("3*pi/2").PiMultiple());
+    EXPECT_EQ(Rational(-5, 4), AST::Parse("-(pi + pi/4)").PiMultiple());
+    EXPECT_EQ(Rational(1, 8), AST::Parse("0.125*pi").PiMultiple());
+    EXPECT_EQ(Rational(9, 10), AST::Parse("pi*09/10").PiMultiple());
+    EXPECT_EQ(Rational(0), AST::Parse("pi - pi").PiMultiple());
+    EXPECT_EQ(Rational(0), AST::Parse("0").PiMultiple());
+    EXPECT_FALSE(AST::Parse("0.1").PiMultiple().has_value());
+    EXPECT_FALSE(AST::Parse("pi + 1").PiMultiple().has_value());
+    EXPECT_FALSE(AST::Parse("pi * pi").PiMultiple().has_value());
+    EXPECT_FALSE(AST::Parse("1 / pi").PiMultiple().has_value());
+    EXPECT_FALSE(AST::Parse("pi / 0").PiMultiple().has_value());
+}
 TEST(Parser, Exceptions) {
     EXPECT_THROW(AST::Parse("pi 10"), std::runtime_error);
     EXPECT_THROW(AST::Parse("10 10"), std::runtime_error);
@@ -0,0 +1,57 @@
+#include "qrot/rotation_index.h"
+
+#include <gtest/gtest.h>
+
+#include "qrot/gridsynth.h"
+#include "qrot/verification.h"
+
+using namespace qrot;
+
+TEST(RotationIndex, FindInsert) {
+    using constant::f::Pi;
+    auto index = RotationIndex(2);
+    EXPECT_FALSE(index.Find(Pi / 2, Float("1e-10")).has_value());
+
+    index.Insert(Pi / 2, Float("1e-100"), *ExactRz(Rational(1, 2)));
+    EXPECT_EQ(1, index.Size());
+    EXPECT_TRUE(index.Find(Pi / 2 + Float("1e-30"), Float("1e-20")).has_value());
+    EXPECT_FALSE(index.Find(Pi / 2 + Float("1e-10"), Float("1e-20")).has_value());
+    EXPECT_TRUE(index.Find(Pi / 2 + Float("1e-10"), Float("1e-9")).has_value());
+    EXPECT_FALSE(index.Find(Pi / 4, Float("1e-9")).has_value());
+
+    // Rz(pi / 2) is the oldest entry
+    index.Insert(Pi, Float("1e-100"), *ExactRz(Rational(1)));
+    index.Insert(0, Float("1e-100"), *ExactRz(Rational(0)));
+    EXPECT_EQ(2, index.Size());
+    EXPECT_FALSE(index.Find(Pi / 2, Float("1e-9")).has_value());
+    EXPECT_TRUE(index.Find(Pi, Float("1e-9")).has_value());
+
+    index.Clear();
+    EXPECT_EQ(0, index.Size());
+
+    // T = e^{i pi / 8} Rz(pi / 4) is found up to global phase
+    index.Insert(Pi / 4, Float("1e-100"), *ExactRz(Rational(1, 4)));
+    EXPECT_TRUE(index.Find(Pi / 4, Float("1e-90")).has_value());
+}
+TEST(RotationIndex, GridSynth) {
+    auto index = RotationIndex();
+    const auto theta = Float("0.3");
+    const auto [gate, stats] = GridSynth(theta, 10, index);
+    EXPECT_FALSE(stats.reused);
+    EXPECT_EQ(1, index.Size());
+
+    // Angles differing in the 13th digit and their Clifford images reuse the gate
+    for (const auto& other : {theta + Float("1e-13"), -theta - Float("1e-13"),
+                              constant::f::Pi / 2 - theta}) {
+        const auto [reused_gate, reused_stats] = GridSynth(other, 10, index);
+        EXPECT_TRUE(reused_stats.reused);
+        EXPECT_EQ(gate.CountT(), reused_gate.CountT());
+        EXPECT_TRUE(VerifyRz(reused_gate, other, Float("1e-10")));
+    }
+    EXPECT_EQ(1, index.Size());
+
+    // A finer precision needs a new search
+    const auto [fine_gate, fine_stats] = GridSynth(theta, 20, index);
+    EXPECT_FALSE(fine_stats.reused);
+    EXPECT_EQ(2, index.Size());
+}
@@ -0,0 +1,59 @@
+#include "qrot/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <latch>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace qrot;
+
+TEST(ThreadPool, Run) {
+    auto pool = ThreadPool(4);
+    auto mtx = std::mutex();
+    auto thread_ids = std::vector<std::set<std::thread::id>>();
+    for (auto run = 0; run < 3; ++run) {
+        auto indices = std::multiset<std::uint32_t>();
+        auto ids = std::set<std::thread::id>();
+        pool.Run([&](std::uint32_t index, std::uint32_t count) {
+            const auto lock = std::lock_guard(mtx);
+            EXPECT_EQ(4, count);
+            indices.insert(index);
+            ids.insert(std::this_thread::get_id());
+        });
+        EXPECT_EQ((std::multiset<std::uint32_t>{0, 1, 2, 3}), indices);
+        EXPECT_EQ(4, ids.size());
+        EXPECT_EQ(1, ids.count(std::this_thread::get_id()));
+        thread_ids.emplace_back(std::move(ids));
+    }
+    // The workers persist across runs
+    EXPECT_EQ(thread_ids[0], thread_ids[1]);
+    EXPECT_EQ(thread_ids[0], thread_ids[2]);
+}
+TEST(ThreadPool, SingleThread) {
+    auto pool = ThreadPool(1);
+    auto calls = 0;
+    pool.Run([&](std::uint32_t index, std::uint32_t count) {
+        EXPECT_EQ(0, index);
+        EXPECT_EQ(1, count);
+        EXPECT_EQ(0, calls++);
+    });
+    EXPECT_EQ(1, calls);
+}
+TEST(ThreadPool, ConcurrentRun) {
+    // A Run while the workers are busy runs the whole task on its caller
+    auto pool = ThreadPool(2);
+    auto started = std::latch(2);
+    auto nested_count = std::atomic<std::uint32_t>(0);
+    pool.Run([&](std::uint32_t index, std::uint32_t) {
+        started.arrive_and_wait();
+        if (index != 0) { return; }
+        auto other = std::jthread([&] {
+            pool.Run([&](std::uint32_t, std::uint32_t count) { nested_count = count; });
+        });
+    });
+    EXPECT_EQ(1, nested_count);
+}
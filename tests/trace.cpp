@@ -0,0 +1,34 @@
+#include "qrot/trace.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace qrot;
+
+TEST(Tracer, Record) {
+    auto& tracer = Tracer::Global();
+    tracer.Clear();
+    { const auto scope = TraceScope("disabled"); }
+    EXPECT_EQ(0, tracer.Size());
+
+    tracer.Enable();
+    {
+        const auto outer = TraceScope("outer");
+        auto thread = std::jthread([] { const auto inner = TraceScope("inner"); });
+    }
+    tracer.Disable();
+    EXPECT_EQ(2, tracer.Size());
+
+    auto ss = std::stringstream();
+    tracer.Write(ss);
+    const auto json = ss.str();
+    EXPECT_NE(std::string::npos, json.find("\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"outer\""));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"inner\""));
+    EXPECT_NE(std::string::npos, json.find("\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, json.find("\"thread_name\""));
+    tracer.Clear();
+}
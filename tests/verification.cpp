@@ -0,0 +1,83 @@
+#include "qrot/verification.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <utility>
+#include <string>
+
+#include "qrot/gridsynth.h"
+#include "qrot/parser.h"
+
+using namespace qrot;
+
+TEST(Verification, ExactUnitary) {
+    for (const auto* word : {"I", "H", "T", "S", "X", "Y", "Z", "W", "HTSHTHTXYZW", "YTHWSZTHXY"}) {
+        const auto gate = Gate::FromString(word);
+        EXPECT_EQ(gate.Mat(), ExactUnitary::FromGate(gate).ToMCD2()) << word;
+    }
+    auto engine = std::mt19937(0);
+    const auto atoms = std::string("HSTXYZW");
+    for (auto i = 0; i < 20; ++i) {
+        auto word = std::string();
+        for (auto j = 0; j < 50; ++j) { word += atoms[engine() % atoms.size()]; }
+        const auto gate = Gate::FromString(word);
+        EXPECT_EQ(gate.Mat(), ExactUnitary::FromGate(gate).ToMCD2()) << word;
+    }
+}
+TEST(Verification, SquaredRzDistance) {
+    using constant::f::Pi;
+    const auto theta = Float("0.7");
+    const auto c = mp::cos(theta / 2);
+    const auto s = mp::sin(theta / 2);
+    const auto tol = Float("1e-250");
+    // e^{i phi} Rz(theta + delta) is at squared distance 4 sin^2(delta / 4) for |delta| <= pi, and
+    // 2 pi apart is -Rz(theta), i.e. the same rotation
+    const auto sin2 = [](const Float& x) { return Float(4 * mp::pow(mp::sin(x / 4), 2)); };
+    const auto cases = {std::pair{Float{0}, Float{0}},
+                        std::pair{Float("1e-40"), sin2(Float("1e-40"))},
+                        std::pair{Float("-0.3"), sin2(Float("-0.3"))},
+                        std::pair{Float(2 * Pi), Float{0}}};
+    for (const auto& [delta, expected] : cases) {
+        const Float half = (theta + delta) / 2;
+        for (const auto& phi : {Float{0}, Float(Pi / 8), Float("-2.5"), Pi}) {
+            const auto phase = Complex(mp::cos(phi), mp::sin(phi));
+            const auto u00 = phase * Complex(mp::cos(half), -mp::sin(half));
+            const auto u11 = phase * Complex(mp::cos(half), mp::sin(half));
+            const auto squared = SquaredRzDistance(u00, u11, c, s);
+            EXPECT_GE(squared, expected) << delta << ' ' << phi;
+            EXPECT_LT(squared - expected, tol) << delta << ' ' << phi;
+        }
+    }
+}
+TEST(Verification, RzDistanceIgnoresGlobalPhase) {
+    using constant::f::Pi;
+    // ExactRz(k / 4) is Rz(k pi / 4) for even k and e^{i pi / 8} Rz(k pi / 4) for odd k
+    for (auto k = -16; k <= 16; ++k) {
+        const auto gate = *ExactRz(Rational(k, 4));
+        const Float theta = k * Pi / 4;
+        EXPECT_LT(RzDistance(gate, theta), Float("1e-240")) << k;
+        EXPECT_TRUE(VerifyRz(gate, theta, Float("1e-100"))) << k;
+        EXPECT_FALSE(VerifyRz(gate, theta + Float("1e-90"), Float("1e-100"))) << k;
+    }
+    // The global phase of a word does not matter, but the rotation does
+    const auto gate = Gate::FromString("HTSHTHTHTSHT");
+    auto phased = gate;
+    for (auto i = 0; i < 3; ++i) { phased *= Atom::W(); }
+    EXPECT_LT(mp::abs(RzDistance(gate, Float("0.4")) - RzDistance(phased, Float("0.4"))),
+              Float("1e-250"));
+}
+TEST(Verification, GridSynth) {
+    const auto epsilon = Float("1e-10");
+    // "0.7853981634" is within epsilon of pi/4 and synthesized exactly as T, i.e. with phase
+    for (const auto* angle : {"pi/128", "-1.987654", "0.7853981634", "3.14159265358979"}) {
+        const auto theta = AST::Parse(angle).Value();
+        const auto [gate, stats] = GridSynth(theta, 10);
+        EXPECT_TRUE(VerifyRz(gate, theta, epsilon)) << angle;
+        EXPECT_FALSE(VerifyRz(gate, theta + Float("1e-8"), epsilon)) << angle;
+    }
+    // A sequence of T-count > 0 is not exact
+    const auto theta = AST::Parse("pi/128").Value();
+    const auto [gate, stats] = GridSynth(theta, 10);
+    EXPECT_FALSE(VerifyRz(gate, theta, Float("1e-20")));
+}